@@ -2,19 +2,52 @@ QT += testlib
 QT -= gui
 #mmmmm
 
-CONFIG += qt console warn_on depend_includepath testcase
+CONFIG += c++17 qt console warn_on depend_includepath testcase
 CONFIG -= app_bundle
 
 TEMPLATE = app
 
 SOURCES += \
      ../tictactoegui/aiplayer.cpp \
+     ../tictactoegui/batcheval.cpp \
      ../tictactoegui/gameboard.cpp \
+     ../tictactoegui/gametree.cpp \
+     ../tictactoegui/gridboard.cpp \
+     ../tictactoegui/linescan.cpp \
+     ../tictactoegui/nnueeval.cpp \
+     ../tictactoegui/perfectplay.cpp \
+     ../tictactoegui/tablebase.cpp \
+     ../tictactoegui/threadpool.cpp \
+     ../tictactoegui/transpositiontable.cpp \
        tst_unittests1.cpp
 
 HEADERS += \
     ../tictactoegui/aiplayer.h \
+    ../tictactoegui/batcheval.h \
+    ../tictactoegui/bitops.h \
+    ../tictactoegui/boardsearch.h \
     ../tictactoegui/gameboard.h \
+    ../tictactoegui/gametree.h \
+    ../tictactoegui/gridboard.h \
+    ../tictactoegui/leafeval.h \
+    ../tictactoegui/linescan.h \
+    ../tictactoegui/linewindows.h \
+    ../tictactoegui/mctssearch.h \
+    ../tictactoegui/mnkboard.h \
+    ../tictactoegui/moveordering.h \
+    ../tictactoegui/nnueeval.h \
+    ../tictactoegui/parallelmcts.h \
+    ../tictactoegui/parallelsearch.h \
+    ../tictactoegui/patterneval.h \
+    ../tictactoegui/perfectplay.h \
+    ../tictactoegui/proofsearch.h \
+    ../tictactoegui/tablebase.h \
+    ../tictactoegui/threatsearch.h \
+    ../tictactoegui/threadpool.h \
+    ../tictactoegui/transpositiontable.h \
+    ../tictactoegui/workstealingdeque.h \
+    ../tictactoegui/ybwcsearch.h \
+    ../tictactoegui/zobrist.h \
 
 SOURCES += tst_unittests1.moc
 
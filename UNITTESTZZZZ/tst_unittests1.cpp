@@ -1,7 +1,22 @@
 #include "../tictactoegui/aiplayer.h"
+#include "../tictactoegui/batcheval.h"
 #include "../tictactoegui/gameboard.h"
+#include "../tictactoegui/gridboard.h"
+#include "../tictactoegui/linescan.h"
+#include "../tictactoegui/mnkboard.h"
+#include "../tictactoegui/nnueeval.h"
+#include "../tictactoegui/proofsearch.h"
+#include "../tictactoegui/threatsearch.h"
 #include <QTest>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <thread>
 
 // Test fixture for AIPlayer unit tests
 class Tests : public QObject {
@@ -21,6 +36,33 @@ private slots:
     void testEvaluatePlayerWinsVertically();
     void testEvaluatePlayerWinsDiagonally();
     void testEvaluateDraw();
+    void testAIMoveTakesWin();
+    void testAIMoveBlocksWin();
+    void testTranspositionTable();
+    void testSearchModesAgree();
+    void testPlayUndoRestoresBoard();
+    void testGameTreeArena();
+    void testCanonicalSymmetry();
+    void testPerfectPlayOracle();
+    void testRetrogradeTablebase();
+    void testMNKBoardLines();
+    void testBoardSearchOnMNKBoards();
+    void testGridBoardWinAfter();
+    void testIterativeDeepeningBudget();
+    void testMoveOrderingCutsNodes();
+    void testPVSMatchesAlphaBeta();
+    void testMTDFConverges();
+    void testParallelRootMatchesSerial();
+    void testLazySMPSharedTable();
+    void testYBWCWorkStealing();
+    void testMCTSReusesTree();
+    void testParallelMCTSVirtualLoss();
+    void testProofSearchSolves();
+    void testThreatSpaceSearch();
+    void testPatternEvaluation();
+    void testSIMDLineScan();
+    void testBatchEvaluation();
+    void testNNUEEvaluation();
 
     //gameboard tests
     void testPlayer1WinsRow();
@@ -36,6 +78,8 @@ private slots:
     void testInitialEmptyBoard();
     void testSetGetValue();
     void testOutOfBoundsAccess();
+    void testBitboardMasks();
+    void testZobristHash();
 
 
 
@@ -208,6 +252,1274 @@ void Tests::testEvaluateDraw() {
     QCOMPARE(aiPlayer.evaluate(board), 0);
 }
 
+void Tests::testAIMoveTakesWin() {
+    AIPlayer aiPlayer;
+    GameBoard board = createBoard({
+        { -1, -1,  0 },
+        {  1,  1,  0 },
+        {  1,  0,  0 }
+    });
+    aiPlayer.makeMove(board);
+    QCOMPARE(board.getValue(0, 2), -1);
+    QCOMPARE(board.checkWin(), -1);
+}
+
+void Tests::testAIMoveBlocksWin() {
+    AIPlayer aiPlayer;
+    GameBoard board = createBoard({
+        {  1,  0,  0 },
+        {  0,  1,  0 },
+        { -1,  0,  0 }
+    });
+    aiPlayer.makeMove(board);
+    QCOMPARE(board.getValue(2, 2), -1);
+
+    // The position after the AI's reply stays cached for the next move
+    TranspositionTable::Entry entry;
+    QVERIFY(aiPlayer.engine.table.probe(board.canonical().hash(), entry));
+}
+
+void Tests::testTranspositionTable() {
+    TranspositionTable table(1000);
+    QCOMPARE(table.size(), size_t(1024)); // Rounded up to a power of two
+
+    TranspositionTable::Entry entry;
+    QVERIFY(!table.probe(42, entry));
+    table.store(42, 1000, TranspositionTable::Lower, 5, 4);
+    QVERIFY(table.probe(42, entry));
+    QCOMPARE(entry.score, 1000);
+    QCOMPARE(int(entry.bound), int(TranspositionTable::Lower));
+    QCOMPARE(int(entry.depth), 5);
+    QCOMPARE(int(entry.bestMove), 4);
+
+    // A shallower result for the same key does not overwrite a deeper one
+    table.store(42, 0, TranspositionTable::Exact, 3, 1);
+    QVERIFY(table.probe(42, entry));
+    QCOMPARE(int(entry.depth), 5);
+
+    // A colliding key replaces the slot, and the old key no longer matches
+    table.store(42 + 1024, -1000, TranspositionTable::Upper, 1, 0);
+    QVERIFY(!table.probe(42, entry));
+
+    table.clear();
+    QVERIFY(!table.probe(42 + 1024, entry));
+}
+void Tests::testSearchModesAgree() {
+    std::vector<GameBoard> boards = {
+        createBoard({ { 1, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 } }),
+        createBoard({ { 0, 0, 0 }, { 0, 1, 0 }, { 0, 0, 0 } }),
+        createBoard({ { 1, -1, 0 }, { 0, 1, 0 }, { 0, 0, 0 } }),
+        createBoard({ { 1, 0, 1 }, { 0, -1, 0 }, { 0, 0, 0 } })
+    };
+    for (const GameBoard& start : boards) {
+        GameBoard tree = start;
+        AIPlayer treePlayer;
+        treePlayer.setSearchMode(SearchMode::GameTree);
+        treePlayer.makeMove(tree);
+
+        GameBoard search = start;
+        AIPlayer searchPlayer;
+        searchPlayer.makeMove(search);
+
+        QCOMPARE(search.hash(), tree.hash());
+    }
+}
+
+void Tests::testPlayUndoRestoresBoard() {
+    GameBoard board = createBoard({
+        {  1,  0,  0 },
+        {  0, -1,  0 },
+        {  0,  0,  0 }
+    });
+    uint64_t hash = board.hash();
+
+    board.play(2, 1);
+    board.play(6, -1);
+    QCOMPARE(board.getValue(0, 2), 1);
+    QCOMPARE(board.getValue(2, 0), -1);
+    QVERIFY(!board.isEmpty(6));
+    board.undo(6);
+    board.undo(2);
+
+    QCOMPARE(board.hash(), hash);
+    QVERIFY(board.isEmpty(2));
+    QVERIFY(board.isEmpty(6));
+    QCOMPARE(board.getValue(0, 0), 1);
+    QCOMPARE(board.getValue(1, 1), -1);
+}
+void Tests::testGameTreeArena() {
+    GameTree tree;
+    GameBoard board;
+    uint32_t root = tree.build(board, 1);
+
+    // Every game of tic-tac-toe, root included, and perfect play draws
+    QCOMPARE(tree.size(), size_t(549946));
+    QCOMPARE(int(tree.node(root).childCount), 9);
+    QCOMPARE(tree.node(root).score, 0);
+
+    // Children are a contiguous index range in board order
+    const GameTree::Node& parent = tree.node(root);
+    for (uint32_t i = 0; i < parent.childCount; i++) {
+        const GameTree::Node& child = tree.node(parent.firstChild + i);
+        QCOMPARE(child.moveRow * 3 + child.moveCol, int(i));
+        QCOMPARE(child.board.getValue(child.moveRow, child.moveCol), 1);
+    }
+
+    tree.reset();
+    QCOMPARE(tree.size(), size_t(0));
+
+    // A won position is a leaf scored like AIPlayer::evaluate
+    GameBoard won = createBoard({ { -1, -1, -1 }, { 1, 1, 0 }, { 1, 0, 0 } });
+    root = tree.build(won, 1);
+    QCOMPARE(tree.size(), size_t(1));
+    QCOMPARE(int(tree.node(root).childCount), 0);
+    QCOMPARE(tree.node(root).score, 1000);
+}
+void Tests::testCanonicalSymmetry() {
+    // A corner opening in each of the four corners has one canonical image
+    GameBoard corners[4];
+    corners[0].setValue(0, 0, 1);
+    corners[1].setValue(0, 2, 1);
+    corners[2].setValue(2, 0, 1);
+    corners[3].setValue(2, 2, 1);
+    for (const GameBoard& board : corners) {
+        QCOMPARE(board.canonical().hash(), corners[0].canonical().hash());
+    }
+
+    GameBoard board = createBoard({
+        {  1,  0,  0 },
+        {  0, -1,  0 },
+        {  0,  1,  0 }
+    });
+    for (int t = 0; t < 8; t++) {
+        QCOMPARE(GameBoard::inverseTransformCell(GameBoard::transformCell(5, t), t), 5);
+
+        // Every image of the board canonicalizes to the same position
+        GameBoard image;
+        for (int cell = 0; cell < 9; cell++) {
+            image.setValue(GameBoard::transformCell(cell, t) / 3, GameBoard::transformCell(cell, t) % 3,
+                           board.getValue(cell / 3, cell % 3));
+        }
+        QCOMPARE(image.canonical().hash(), board.canonical().hash());
+    }
+
+    // The canonical board is the transformed board, and moves map back
+    int transform = -1;
+    GameBoard canonical = board.canonical(&transform);
+    for (int cell = 0; cell < 9; cell++) {
+        int mapped = GameBoard::transformCell(cell, transform);
+        QCOMPARE(canonical.getValue(mapped / 3, mapped % 3), board.getValue(cell / 3, cell % 3));
+        QCOMPARE(GameBoard::inverseTransformCell(mapped, transform), cell);
+    }
+}
+void Tests::testPerfectPlayOracle() {
+    QCOMPARE(perfectPlay(GameBoard(), 1).value, 0);
+    QCOMPARE(perfectPlay(GameBoard(), 1).distance, 9);
+    QCOMPARE(int(perfectPlay(GameBoard(), 1).moves), 0x1FF); // Every opening draws
+
+    // Walk every game where player 1 opens and check the AI search and the
+    // tablebase move against the table value of each AI-to-move position
+    AIPlayer searchPlayer;
+    AIPlayer tablePlayer;
+    tablePlayer.setSearchMode(SearchMode::Tablebase);
+    int checked = 0;
+    std::set<uint64_t> seen;
+    std::function<void(GameBoard&, int)> walk = [&](GameBoard& board, int player) {
+        if (board.checkWin() != 0 || !seen.insert(board.hash()).second) {
+            return;
+        }
+        PerfectPlay play = perfectPlay(board, player);
+        QVERIFY(play.known);
+        if (player == -1) {
+            int score = searchPlayer.engine.alphaBeta(board, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), true, 9);
+            QCOMPARE(score, play.value * 1000);
+
+            GameBoard reply = board;
+            int cell = tablePlayer.bestMoveFromTablebase(reply);
+            QVERIFY(cell >= 0 && reply.isEmpty(cell));
+            reply.play(cell, -1);
+            QCOMPARE(-perfectPlay(reply, 1).value, play.value);
+            ++checked;
+        }
+        for (int cell = 0; cell < 9; cell++) {
+            if (board.isEmpty(cell)) {
+                board.play(cell, player);
+                walk(board, -player);
+                board.undo(cell);
+            }
+        }
+    };
+    GameBoard board;
+    walk(board, 1);
+    QVERIFY(checked > 0);
+}
+void Tests::testRetrogradeTablebase() {
+    // Index round trip on a 4x4 level
+    TablebaseIndex index(4, 4, 4);
+    for (uint64_t i = 0; i < index.levelSize(5); i += 97) {
+        uint64_t first;
+        uint64_t second;
+        index.unrank(5, i, first, second);
+        QCOMPARE(index.rank(first, second), i);
+    }
+
+    // Solve 3x3 on two threads and check it against the compile-time table
+    const std::string path = "test_tablebase_3x3.tb";
+    TablebaseOptions options;
+    options.path = path;
+    options.threads = 2;
+    std::string error;
+    QVERIFY(generateTablebase(options, &error));
+
+    AIPlayer aiPlayer;
+    QVERIFY(aiPlayer.loadTablebase(path));
+    const Tablebase& tablebase = aiPlayer.tablebase;
+    QCOMPARE(int(tablebase.probe(0, 0)), int(Tablebase::Draw));
+
+    std::set<uint64_t> seen;
+    std::function<void(GameBoard&, int)> walk = [&](GameBoard& board, int player) {
+        if (!seen.insert(board.hash()).second) {
+            return;
+        }
+        PerfectPlay play = perfectPlay(board, player);
+        QCOMPARE(int(tablebase.probe(board.mask(1), board.mask(-1))), play.value + 1);
+        if (board.checkWin() != 0) {
+            return;
+        }
+        // The file's move keeps the game-theoretic value
+        int cell = tablebase.bestMove(board.mask(1), board.mask(-1));
+        QVERIFY(cell >= 0 && board.isEmpty(cell));
+        board.play(cell, player);
+        QCOMPARE(perfectPlay(board, -player).value, -play.value);
+        board.undo(cell);
+        for (int next = 0; next < 9; next++) {
+            if (board.isEmpty(next)) {
+                board.play(next, player);
+                walk(board, -player);
+                board.undo(next);
+            }
+        }
+    };
+    GameBoard board;
+    walk(board, 1);
+
+    // Positions from a game the AI opened are not in the file
+    QCOMPARE(int(tablebase.probe(0, 1)), int(Tablebase::Unknown));
+    aiPlayer.tablebase.close();
+
+    // Damaged headers are refused at open rather than read out of bounds.
+    // The header is the magic, rows, cols, k, cells, then 64-bit level offsets.
+    std::ifstream original(path, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(original)), std::istreambuf_iterator<char>());
+    original.close();
+    const size_t kField = 8;
+    const size_t kOffsets = 24;
+    auto openModified = [&](const std::vector<char>& contents) {
+        const std::string copy = "test_tablebase_damaged.tb";
+        std::ofstream(copy, std::ios::binary).write(contents.data(), std::streamsize(contents.size()));
+        Tablebase damaged;
+        bool opened = damaged.open(copy);
+        damaged.close();
+        std::remove(copy.c_str());
+        return opened;
+    };
+    QVERIFY(openModified(bytes));
+    uint64_t offsets[11];
+    QVERIFY(bytes.size() > kOffsets + sizeof(offsets));
+    // Level 4 loses a byte; the later offsets shift, so the end offset still matches the length
+    std::vector<char> truncated = bytes;
+    std::memcpy(offsets, truncated.data() + kOffsets, sizeof(offsets));
+    truncated.erase(truncated.begin() + std::ptrdiff_t(offsets[4]));
+    for (int level = 5; level <= 10; level++) {
+        offsets[level]--;
+    }
+    std::memcpy(truncated.data() + kOffsets, offsets, sizeof(offsets));
+    QVERIFY(!openModified(truncated));
+    // No win length, or one longer than the board
+    for (uint32_t k : { 0u, 4u }) {
+        std::vector<char> badK = bytes;
+        std::memcpy(badK.data() + kField + 2 * sizeof(uint32_t), &k, sizeof(k));
+        QVERIFY(!openModified(badK));
+    }
+    std::remove(path.c_str());
+
+    // Failures leave neither a truncated file nor level files behind
+    TablebaseOptions unwritable;
+    unwritable.rows = 2;
+    unwritable.cols = 2;
+    unwritable.k = 2;
+    unwritable.path = "missing_dir/test_tablebase_2x2.tb";
+    unwritable.tempDir = ".";
+    QVERIFY(!generateTablebase(unwritable, &error));
+    for (int level = 0; level <= 4; level++) {
+        QVERIFY(!std::ifstream("./tablebase.level" + std::to_string(level) + ".tmp").is_open());
+    }
+    unwritable.path = "test_tablebase_2x2.tb";
+    unwritable.tempDir = "missing_dir";
+    QVERIFY(!generateTablebase(unwritable, &error));
+    QVERIFY(!std::ifstream(unwritable.path).is_open());
+}
+void Tests::testMNKBoardLines() {
+    static_assert(MNKBoard<3, 3, 3>::kLines == 8, "rows, columns and two diagonals");
+    static_assert(MNKBoard<4, 4, 4>::kLines == 10, "rows, columns and two diagonals");
+    static_assert(MNKBoard<15, 15, 5>::kLines == 572, "11 windows per row and column, 121 per diagonal direction");
+
+    // The 3x3x3 instantiation agrees with GameBoard on every win and draw
+    std::mt19937 random(7);
+    for (int game = 0; game < 200; game++) {
+        GameBoard reference;
+        MNKBoard<3, 3, 3> board;
+        int player = 1;
+        int cells[9] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+        std::shuffle(cells, cells + 9, random);
+        for (int cell : cells) {
+            reference.play(cell, player);
+            board.play(cell, player);
+            QCOMPARE(board.checkWinAfter(cell), reference.checkWin());
+            QCOMPARE(board.checkWin(), reference.checkWin());
+            QCOMPARE(reference.checkWinAfter(cell), reference.checkWin());
+            if (reference.checkWin() != 0) {
+                break;
+            }
+            player = -player;
+        }
+    }
+
+    // Anti-diagonal five on a 15x15 board, found from its last stone only
+    MNKBoard<15, 15, 5> gomoku;
+    for (int i = 0; i < 4; i++) {
+        gomoku.setValue(3 + i, 10 - i, -1);
+    }
+    QCOMPARE(gomoku.checkWin(), 0);
+    gomoku.setValue(7, 6, -1);
+    QCOMPARE(gomoku.checkWinAfter(7 * 15 + 6), -1);
+    QCOMPARE(gomoku.checkWin(), -1);
+    gomoku.undo(7 * 15 + 6);
+    QCOMPARE(gomoku.checkWin(), 0);
+    QCOMPARE(gomoku.stones(), 4);
+}
+
+void Tests::testBoardSearchOnMNKBoards() {
+    // Same search code on the generic 3x3 board: perfect play draws
+    MNKBoard<3, 3, 3> small;
+    BoardSearch<MNKBoard<3, 3, 3>> smallSearch;
+    QCOMPARE(smallSearch.alphaBeta(small, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), false, 9), 0);
+
+    // 4x4x4: complete the column, otherwise block the opponent's row
+    MNKBoard<4, 4, 4> board;
+    BoardSearch<MNKBoard<4, 4, 4>> search;
+    board.setValue(0, 0, -1);
+    board.setValue(1, 0, -1);
+    board.setValue(2, 0, -1);
+    board.setValue(1, 1, 1);
+    board.setValue(1, 2, 1);
+    board.setValue(1, 3, 1);
+    board.setValue(2, 2, 1);
+    QCOMPARE(search.bestMove(board, -1, 2), 3 * 4 + 0);
+
+    MNKBoard<4, 4, 4> defend;
+    defend.setValue(3, 0, 1);
+    defend.setValue(3, 1, 1);
+    defend.setValue(3, 2, 1);
+    defend.setValue(0, 0, -1);
+    defend.setValue(1, 1, -1);
+    QCOMPARE(search.bestMove(defend, -1, 2), 3 * 4 + 3);
+}
+void Tests::testGridBoardWinAfter() {
+    // GUI path: setValue keeps checkWin() current on a 19x19 board
+    GridBoard board(19, 19, 5);
+    for (int i = 0; i < 4; i++) {
+        board.setValue(18 - i, i, 1);
+    }
+    QCOMPARE(board.checkWin(), 0);
+    board.setValue(14, 4, 1);
+    QCOMPARE(board.checkWinAfter(14, 4), 1);
+    QCOMPARE(board.checkWin(), 1);
+    board.setValue(16, 2, -1); // Breaking the line clears the win
+    QCOMPARE(board.checkWin(), 0);
+    QCOMPARE(board.stones(), 5);
+
+    // Search path: play/undo agree with the compile-time 4x4x4 board
+    std::mt19937 random(11);
+    for (int game = 0; game < 200; game++) {
+        GridBoard grid(4, 4, 4);
+        MNKBoard<4, 4, 4> reference;
+        std::vector<int> cells(16);
+        for (int i = 0; i < 16; i++) {
+            cells[i] = i;
+        }
+        std::shuffle(cells.begin(), cells.end(), random);
+        int player = 1;
+        int played = 0;
+        for (int cell : cells) {
+            grid.play(cell, player);
+            reference.play(cell, player);
+            played++;
+            QCOMPARE(grid.checkWinAfter(cell), reference.checkWin());
+            QCOMPARE(grid.checkWin(), reference.checkWin());
+            if (grid.checkWin() != 0) {
+                break;
+            }
+            player = -player;
+        }
+        for (int i = played - 1; i >= 0; i--) {
+            grid.undo(cells[i]);
+        }
+        QCOMPARE(grid.hash(), uint64_t(0));
+        QCOMPARE(grid.checkWin(), 0);
+    }
+
+    GridBoard defend(4, 4, 4);
+    defend.setValue(3, 0, 1);
+    defend.setValue(3, 1, 1);
+    defend.setValue(3, 2, 1);
+    defend.setValue(0, 0, -1);
+    defend.setValue(1, 1, -1);
+    BoardSearch<GridBoard> search;
+    QCOMPARE(search.bestMove(defend, -1, 2), 3 * 4 + 3);
+}
+void Tests::testIterativeDeepeningBudget() {
+    // Unlimited on 3x3: deepens to the end of the game and finds the draw
+    GameBoard board;
+    BoardSearch<GameBoard> small;
+    SearchLimits unlimited;
+    QVERIFY(small.bestMove(board, -1, unlimited) >= 0);
+    QCOMPARE(small.lastSearch().depth, 9);
+    QCOMPARE(small.lastSearch().score, 0);
+
+    // 5x5x4 cannot be solved in 30 ms: the search returns on time with a
+    // legal move from the last completed depth
+    MNKBoard<5, 5, 4> big;
+    big.setValue(2, 2, 1);
+    BoardSearch<MNKBoard<5, 5, 4>> search;
+    SearchLimits limits;
+    limits.timeMs = 30;
+    auto start = std::chrono::steady_clock::now();
+    int cell = search.bestMove(big, -1, limits);
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    QVERIFY(cell >= 0 && big.isEmpty(cell));
+    QVERIFY(elapsed < 30 + 5);
+    QVERIFY(search.lastSearch().depth >= 1);
+
+    // A node budget stops the search too
+    limits.timeMs = 0;
+    limits.nodes = 5000;
+    QVERIFY(search.bestMove(big, -1, limits) >= 0);
+    QVERIFY(search.lastSearch().nodes <= 5000 + 256);
+
+    // Difficulty levels map to increasing budgets
+    QVERIFY(AIPlayer::limitsFor(Difficulty::Easy).maxDepth < AIPlayer::limitsFor(Difficulty::Medium).maxDepth);
+    QVERIFY(AIPlayer::limitsFor(Difficulty::Medium).timeMs < AIPlayer::limitsFor(Difficulty::Hard).timeMs);
+}
+void Tests::testMoveOrderingCutsNodes() {
+    // 4x4, k = 3 is a first-player win; ordering must find the same result
+    // in fewer nodes, with more cutoffs on the first move tried
+    typedef MNKBoard<4, 4, 3> Board;
+    Board board;
+    SearchLimits limits;
+    BoardSearch<Board> plain;
+    plain.setMoveOrdering(false);
+    int plain_cell = plain.bestMove(board, 1, limits);
+    SearchStats plain_stats = plain.lastSearch();
+
+    BoardSearch<Board> ordered;
+    int ordered_cell = ordered.bestMove(board, 1, limits);
+    SearchStats ordered_stats = ordered.lastSearch();
+
+    QCOMPARE(ordered_cell, plain_cell);
+    QCOMPARE(ordered_stats.score, BoardSearch<Board>::kWinScore);
+    QCOMPARE(ordered_stats.score, plain_stats.score);
+    QVERIFY(ordered_stats.nodes < plain_stats.nodes);
+    QVERIFY(ordered_stats.firstMoveCutoffRate() > plain_stats.firstMoveCutoffRate());
+    QVERIFY(ordered_stats.firstMoveCutoffs <= ordered_stats.cutoffs);
+}
+void Tests::testPVSMatchesAlphaBeta() {
+    // Same value for every reachable 3x3 position a few plies deep
+    std::mt19937 rng(13);
+    BoardSearch<GameBoard> alphaBeta;
+    BoardSearch<GameBoard> pvs;
+    pvs.setAlgorithm(SearchAlgorithm::PVS);
+    for (int game = 0; game < 50; game++) {
+        GameBoard board;
+        int player = 1;
+        for (int ply = 0; ply < 9 && board.checkWin() == 0; ply++) {
+            bool is_max = player == -1; // Both engines maximize for -1
+            QCOMPARE(pvs.alphaBeta(board, -1001, 1001, is_max, 9),
+                     alphaBeta.alphaBeta(board, -1001, 1001, is_max, 9));
+            int cell;
+            do {
+                cell = int(rng() % 9);
+            } while (!board.isEmpty(cell));
+            board.play(cell, player);
+            player = -player;
+        }
+    }
+
+    // And the same move and score from iterative deepening on 4x4, k = 3
+    typedef MNKBoard<4, 4, 3> Board;
+    Board board;
+    SearchLimits limits;
+    BoardSearch<Board> plain;
+    BoardSearch<Board> negascout;
+    negascout.setAlgorithm(SearchAlgorithm::PVS);
+    QCOMPARE(negascout.bestMove(board, 1, limits), plain.bestMove(board, 1, limits));
+    QCOMPARE(negascout.lastSearch().score, plain.lastSearch().score);
+}
+void Tests::testMTDFConverges() {
+    // From random 3x3 positions, MTD(f) reaches the alpha-beta value, and
+    // its move keeps that value
+    std::mt19937 rng(14);
+    BoardSearch<GameBoard> reference;
+    AIPlayer aiPlayer;
+    aiPlayer.setSearchMode(SearchMode::MTDF);
+    SearchLimits limits;
+    for (int game = 0; game < 30; game++) {
+        GameBoard board;
+        int player = 1;
+        for (int ply = 0; ply < 8 && board.checkWin() == 0; ply++) {
+            if (player == -1) {
+                int value = reference.alphaBeta(board, -1001, 1001, true, 9);
+                int cell = aiPlayer.mtdEngine.bestMove(board, -1, limits);
+                QCOMPARE(aiPlayer.mtdEngine.lastSearch().score, value);
+                board.play(cell, -1);
+                QCOMPARE(reference.alphaBeta(board, -1001, 1001, false, 9), value);
+                board.undo(cell);
+                // Three outcomes: each depth settles in a couple of passes
+                QVERIFY(aiPlayer.mtdEngine.lastSearch().passes <= uint64_t(3 * aiPlayer.mtdEngine.lastSearch().depth));
+            }
+            int cell;
+            do {
+                cell = int(rng() % 9);
+            } while (!board.isEmpty(cell));
+            board.play(cell, player);
+            player = -player;
+        }
+    }
+
+    // The AIPlayer mode takes an immediate win
+    GameBoard board = createBoard({
+        { -1, -1,  0 },
+        {  1,  1,  0 },
+        {  1,  0,  0 }
+    });
+    aiPlayer.makeMove(board);
+    QCOMPARE(board.getValue(0, 2), -1);
+}
+void Tests::testParallelRootMatchesSerial() {
+    // Four workers pick the same move and score as the serial search, at
+    // every depth limit and whatever order the workers finish in
+    std::mt19937 rng(15);
+    ParallelSearch<GameBoard> parallel(4);
+    QCOMPARE(parallel.threads(), 4);
+    for (int game = 0; game < 20; game++) {
+        GameBoard board;
+        int player = 1;
+        for (int ply = 0; ply < 8 && board.checkWin() == 0; ply++) {
+            for (int depth : { 2, 4, 64 }) {
+                SearchLimits limits;
+                limits.maxDepth = depth;
+                BoardSearch<GameBoard> serial;
+                QCOMPARE(parallel.bestMove(board, player, limits), serial.bestMove(board, player, limits));
+                QCOMPARE(parallel.lastSearch().score, serial.lastSearch().score);
+            }
+            int cell;
+            do {
+                cell = int(rng() % 9);
+            } while (!board.isEmpty(cell));
+            board.play(cell, player);
+            player = -player;
+        }
+    }
+
+    typedef MNKBoard<4, 4, 3> Board;
+    Board board;
+    SearchLimits limits;
+    ParallelSearch<Board> split(3);
+    BoardSearch<Board> serial;
+    QCOMPARE(split.bestMove(board, 1, limits), serial.bestMove(board, 1, limits));
+    QCOMPARE(split.lastSearch().score, BoardSearch<Board>::kWinScore);
+
+    // The AIPlayer mode still takes a win
+    AIPlayer aiPlayer;
+    aiPlayer.setSearchMode(SearchMode::ParallelRoot);
+    GameBoard position = createBoard({
+        { -1,  1,  0 },
+        { -1,  1,  0 },
+        {  0,  0,  1 }
+    });
+    aiPlayer.makeMove(position);
+    QCOMPARE(position.getValue(2, 0), -1);
+}
+void Tests::testLazySMPSharedTable() {
+    // Threads hammering the same slots never read another key's entry:
+    // every hit carries the score that was stored with its key
+    TranspositionTable table(64);
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&table, &mismatches, t] {
+            for (uint64_t i = 0; i < 200000; i++) {
+                uint64_t key = (i * 7 + uint64_t(t)) % 1024;
+                table.store(key, int(key) * 3, TranspositionTable::Exact, int(i % 100), int(key % 9));
+                TranspositionTable::Entry entry;
+                uint64_t probe_key = (i * 13) % 1024;
+                if (table.probe(probe_key, entry) && (entry.score != int(probe_key) * 3 || entry.bestMove != int(probe_key % 9))) {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    QCOMPARE(mismatches.load(), 0);
+
+    // Four threads on one table reach the serial values
+    std::mt19937 rng(16);
+    LazySMPSearch<GameBoard> smp(4, 1 << 12);
+    for (int game = 0; game < 10; game++) {
+        GameBoard board;
+        int player = 1;
+        for (int ply = 0; ply < 8 && board.checkWin() == 0; ply++) {
+            SearchLimits limits;
+            BoardSearch<GameBoard> serial;
+            serial.bestMove(board, player, limits);
+            int cell = smp.bestMove(board, player, limits);
+            QCOMPARE(smp.lastSearch().score, serial.lastSearch().score);
+            board.play(cell, player);
+            QCOMPARE(serial.alphaBeta(board, -1001, 1001, false, 9), serial.lastSearch().score);
+            board.undo(cell);
+            do {
+                cell = int(rng() % 9);
+            } while (!board.isEmpty(cell));
+            board.play(cell, player);
+            player = -player;
+        }
+    }
+}
+void Tests::testYBWCWorkStealing() {
+    // Owner pops LIFO, thieves steal FIFO, and the buffer grows past its
+    // first capacity
+    WorkStealingDeque<int> deque(4);
+    for (int i = 0; i < 10; i++) {
+        deque.push(i);
+    }
+    int item = -1;
+    QVERIFY(deque.steal(item));
+    QCOMPARE(item, 0);
+    QVERIFY(deque.pop(item));
+    QCOMPARE(item, 9);
+
+    // Under contention every item is taken exactly once
+    std::vector<std::atomic<int>> taken(20000);
+    std::atomic<bool> done(false);
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; t++) {
+        thieves.emplace_back([&] {
+            int stolen;
+            while (!done || !deque.empty()) {
+                if (deque.steal(stolen)) {
+                    taken[size_t(stolen)]++;
+                }
+            }
+        });
+    }
+    for (int i = 10; i < 20000; i++) {
+        deque.push(i);
+        if (i % 3 == 0 && deque.pop(item)) {
+            taken[size_t(item)]++;
+        }
+    }
+    done = true;
+    for (std::thread& thief : thieves) {
+        thief.join();
+    }
+    while (deque.pop(item)) {
+        taken[size_t(item)]++;
+    }
+    for (int i = 10; i < 20000; i++) {
+        QCOMPARE(taken[size_t(i)].load(), 1);
+    }
+
+    // The parallel search gives the serial move and score
+    std::mt19937 rng(17);
+    YBWCSearch<GameBoard> ybwc(4, 1 << 12, 2);
+    for (int game = 0; game < 10; game++) {
+        GameBoard board;
+        int player = 1;
+        for (int ply = 0; ply < 8 && board.checkWin() == 0; ply++) {
+            SearchLimits limits;
+            BoardSearch<GameBoard> serial;
+            ybwc.clear();
+            QCOMPARE(ybwc.bestMove(board, player, limits), serial.bestMove(board, player, limits));
+            QCOMPARE(ybwc.lastSearch().score, serial.lastSearch().score);
+            int cell;
+            do {
+                cell = int(rng() % 9);
+            } while (!board.isEmpty(cell));
+            board.play(cell, player);
+            player = -player;
+        }
+    }
+
+    typedef MNKBoard<5, 5, 4> Board;
+    Board board;
+    SearchLimits limits;
+    limits.maxDepth = 5;
+    YBWCSearch<Board> deep(4);
+    BoardSearch<Board> serial;
+    QCOMPARE(deep.bestMove(board, 1, limits), serial.bestMove(board, 1, limits));
+    QCOMPARE(deep.lastSearch().score, serial.lastSearch().score);
+    QVERIFY(deep.lastSearch().splits > 0);
+
+    // Workers order moves like the serial engine: killers and history put
+    // the refutation first at nearly every cutoff, and ordering off gives
+    // the same result
+    QVERIFY(deep.lastSearch().cutoffs > 0);
+    QVERIFY(deep.lastSearch().firstMoveCutoffRate() > 0.9);
+    YBWCSearch<Board> unordered(4);
+    unordered.setMoveOrdering(false);
+    QCOMPARE(unordered.bestMove(board, 1, limits), serial.bestMove(board, 1, limits));
+    QCOMPARE(unordered.lastSearch().score, serial.lastSearch().score);
+}
+
+void Tests::testMCTSReusesTree() {
+    // Takes the immediate win on row 1
+    GameBoard board;
+    board.play(0, 1);
+    board.play(3, -1);
+    board.play(1, 1);
+    board.play(4, -1);
+    board.play(8, 1);
+    SearchLimits limits;
+    limits.nodes = 2000;
+    MCTSSearch<GameBoard> mcts;
+    QCOMPARE(mcts.bestMove(board, -1, limits), 5);
+    QCOMPARE(mcts.lastSearch().playouts, uint64_t(2000));
+
+    // After its move and the opponent's reply the matching subtree is kept
+    GameBoard game;
+    mcts.reset();
+    int cell = mcts.bestMove(game, -1, limits);
+    QCOMPARE(mcts.lastSearch().reusedNodes, 0u);
+    game.play(cell, -1);
+    int reply = cell == 0 ? 1 : 0;
+    game.play(reply, 1);
+    mcts.bestMove(game, -1, limits);
+    QVERIFY(mcts.lastSearch().reusedNodes > 0);
+    QVERIFY(mcts.lastSearch().rootVisits > 2000);
+
+    // A position that does not follow from the last one starts afresh
+    GameBoard other;
+    other.play(8, 1);
+    mcts.bestMove(other, -1, limits);
+    QCOMPARE(mcts.lastSearch().reusedNodes, 0u);
+
+    // 15x15: stops on the time budget
+    typedef MNKBoard<15, 15, 5> Board;
+    Board big;
+    big.play(112, 1);
+    SearchLimits timed;
+    timed.timeMs = 30;
+    MCTSSearch<Board> gomoku;
+    auto start = std::chrono::steady_clock::now();
+    int move = gomoku.bestMove(big, -1, timed);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    QVERIFY(move >= 0 && big.isEmpty(move));
+    QVERIFY(gomoku.lastSearch().playouts > 0);
+    QVERIFY(elapsed.count() < 60);
+
+    // GridBoard has no default constructor; the root comes from the first call
+    GridBoard grid(4, 4, 4);
+    grid.play(0, 1);
+    grid.play(4, -1);
+    grid.play(1, 1);
+    grid.play(5, -1);
+    grid.play(2, 1);
+    MCTSSearch<GridBoard> gridSearch;
+    QCOMPARE(gridSearch.bestMove(grid, -1, limits), 3);
+}
+
+void Tests::testParallelMCTSVirtualLoss() {
+    // Four threads share one tree and still take the immediate win
+    GameBoard board;
+    board.play(0, 1);
+    board.play(3, -1);
+    board.play(1, 1);
+    board.play(4, -1);
+    board.play(8, 1);
+    SearchLimits limits;
+    limits.nodes = 4000;
+    ParallelMCTSSearch<GameBoard> mcts(4, 1 << 16);
+    QCOMPARE(mcts.bestMove(board, -1, limits), 5);
+
+    // The playout budget is shared exactly and every playout is backed up
+    const MCTSStats& stats = mcts.lastSearch();
+    QCOMPARE(stats.playouts, uint64_t(4000));
+    uint64_t total = 0;
+    for (int i = 0; i < mcts.threads(); i++) {
+        total += mcts.threadPlayouts(i);
+    }
+    QCOMPARE(total, uint64_t(4000));
+    QCOMPARE(stats.rootVisits, 4000u);
+
+    // Blocks the opponent's row, and fills the pool without overrunning it
+    GameBoard threat;
+    threat.play(0, 1);
+    threat.play(4, -1);
+    threat.play(1, 1);
+    ParallelMCTSSearch<GameBoard> small(4, 64);
+    QCOMPARE(small.bestMove(threat, -1, limits), 2);
+    QVERIFY(small.lastSearch().treeNodes <= 64u);
+
+    // Also runs on GridBoard, which has no default constructor
+    GridBoard grid(4, 4, 4);
+    grid.play(0, 1);
+    grid.play(4, -1);
+    grid.play(1, 1);
+    grid.play(5, -1);
+    grid.play(2, 1);
+    ParallelMCTSSearch<GridBoard> gridSearch(4, 1 << 16);
+    QCOMPARE(gridSearch.bestMove(grid, -1, limits), 3);
+}
+
+void Tests::testProofSearchSolves() {
+    // Same value as the full-depth alpha-beta on random 3x3 positions
+    std::mt19937 rng(20);
+    ProofSearch<GameBoard> solver(1 << 20);
+    for (int game = 0; game < 20; game++) {
+        GameBoard board;
+        int player = 1;
+        for (int ply = 0; ply < 7 && board.checkWin() == 0; ply++) {
+            BoardSearch<GameBoard> search;
+            search.bestMove(board, player, SearchLimits());
+            int score = search.lastSearch().score;
+            ProofResult expected = score > 0 ? ProofResult::Win : score < 0 ? ProofResult::Loss : ProofResult::Draw;
+            QVERIFY(solver.solve(board, player) == expected);
+            if (expected != ProofResult::Loss) {
+                // The move it returns keeps the value
+                int cell = solver.bestMove();
+                QVERIFY(board.isEmpty(cell));
+                GameBoard after = board;
+                after.play(cell, player);
+                ProofResult reply = solver.solve(after, -player);
+                int winner = after.checkWin();
+                QVERIFY(winner == player || reply == (expected == ProofResult::Win ? ProofResult::Loss : ProofResult::Draw));
+            }
+            int cell;
+            do {
+                cell = int(rng() % 9);
+            } while (!board.isEmpty(cell));
+            board.play(cell, player);
+            player = -player;
+        }
+    }
+
+    // 4x4 k3 is a first-player win; a tiny table forces garbage collection
+    typedef MNKBoard<4, 4, 3> Board;
+    ProofSearch<Board> small(1 << 12);
+    QVERIFY(small.solve(Board(), 1) == ProofResult::Win);
+    QVERIFY(small.lastSearch().gcRuns > 0);
+    QVERIFY(small.lastSearch().tableEntries < 128u);
+
+    // 15x15 k5: a four on row 7 forces the block, then column 4 becomes an
+    // open four. Five plies deep, but forced blocks keep the proof narrow.
+    typedef MNKBoard<15, 15, 5> Gomoku;
+    Gomoku puzzle;
+    for (int cell : {7 * 15 + 1, 7 * 15 + 2, 7 * 15 + 3, 8 * 15 + 4, 9 * 15 + 4}) {
+        puzzle.play(cell, 1);
+    }
+    for (int cell : {7 * 15, 14, 14 * 15, 14 * 15 + 14, 2 * 15 + 10}) {
+        puzzle.play(cell, -1);
+    }
+    ProofSearch<Gomoku> gomoku(1 << 22);
+    QVERIFY(gomoku.solve(puzzle, 1) == ProofResult::Win);
+    QVERIFY(gomoku.lastSearch().nodes < 20000);
+    puzzle.play(gomoku.bestMove(), 1);
+    QVERIFY(gomoku.solve(puzzle, -1) == ProofResult::Loss);
+
+    // Running out of budget is reported, not guessed
+    typedef MNKBoard<5, 5, 4> Wide;
+    ProofSearch<Wide> limited(1 << 16);
+    SearchLimits limits;
+    limits.nodes = 2000;
+    QVERIFY(limited.solve(Wide(), 1, limits) == ProofResult::Unknown);
+    QCOMPARE(limited.bestMove(), -1);
+}
+
+void Tests::testThreatSpaceSearch() {
+    typedef MNKBoard<15, 15, 5> Gomoku;
+    ThreatSearch<Gomoku> threats;
+
+    // VCF: a four on row 7 forces the block, then column 4 becomes an open four
+    Gomoku fours;
+    for (int cell : {7 * 15 + 1, 7 * 15 + 2, 7 * 15 + 3, 8 * 15 + 4, 9 * 15 + 4}) {
+        fours.play(cell, 1);
+    }
+    for (int cell : {7 * 15, 14, 14 * 15, 14 * 15 + 14, 2 * 15 + 10}) {
+        fours.play(cell, -1);
+    }
+    QCOMPARE(threats.findWin(fours, 1), 7 * 15 + 4);
+    QCOMPARE(threats.lastSearch().depth, 2);
+    QVERIFY(!threats.lastSearch().vct);
+    // The line alternates attacker and forced replies and ends in five
+    int player = 1;
+    for (int cell : threats.sequence()) {
+        QVERIFY(fours.isEmpty(cell));
+        fours.play(cell, player);
+        player = -player;
+    }
+    QCOMPARE(fours.checkWin(), 1);
+
+    // VCT: (7, 8) makes two open threes; no fours are available
+    Gomoku fork;
+    for (int cell : {7 * 15 + 6, 7 * 15 + 7, 5 * 15 + 8, 6 * 15 + 8}) {
+        fork.play(cell, 1);
+    }
+    for (int cell : {0, 14, 14 * 15, 14 * 15 + 14}) {
+        fork.play(cell, -1);
+    }
+    QCOMPARE(threats.findWin(fork, 1), 7 * 15 + 8);
+    QVERIFY(threats.lastSearch().vct);
+
+    // No forced win after two quiet moves, and none claimed
+    Gomoku quiet;
+    quiet.play(112, 1);
+    quiet.play(113, -1);
+    QCOMPARE(threats.findWin(quiet, 1), -1);
+
+    // 3x3: the corner fork is found for the AI before its regular search
+    GameBoard board;
+    board.play(0, -1);
+    board.play(1, 1);
+    board.play(4, -1);
+    board.play(8, 1);
+    ThreatSearch<GameBoard> small;
+    int cell = small.findWin(board, -1);
+    QVERIFY(cell == 3 || cell == 6);
+    AIPlayer ai;
+    ai.makeMove(board);
+    QCOMPARE(board.getValue(cell / 3, cell % 3), -1);
+}
+
+void Tests::testPatternEvaluation() {
+    // Table entries: one side's stones score 4^(n - 1), mixed windows nothing
+    PatternEvaluator<GameBoard> small;
+    small.reset(GameBoard());
+    QCOMPARE(small.patternScore(1 + 1 * 3), 4);  // X X -
+    QCOMPARE(small.patternScore(2), -1);         // O - -
+    QCOMPARE(small.patternScore(1 + 2 * 3), 0);  // X O -
+    QCOMPARE(small.rawScore(), 0);
+
+    // Incremental updates match a rescan through random play and takeback
+    typedef MNKBoard<15, 15, 5> Gomoku;
+    std::mt19937 rng(22);
+    Gomoku board;
+    PatternEvaluator<Gomoku> incremental;
+    PatternEvaluator<Gomoku> rescan;
+    incremental.reset(board);
+    std::vector<int> played;
+    int player = 1;
+    for (int ply = 0; ply < 60; ply++) {
+        int cell;
+        do {
+            cell = int(rng() % 225);
+        } while (!board.isEmpty(cell));
+        board.play(cell, player);
+        incremental.place(cell, player);
+        played.push_back(cell);
+        player = -player;
+        rescan.reset(board);
+        QCOMPARE(incremental.rawScore(), rescan.rawScore());
+    }
+    while (!played.empty()) {
+        int cell = played.back();
+        played.pop_back();
+        player = -player;
+        board.undo(cell);
+        incremental.remove(cell, player);
+    }
+    QCOMPARE(incremental.rawScore(), 0);
+
+    // A depth-2 search now sees the open three and blocks it
+    Gomoku three;
+    three.play(7 * 15 + 6, 1);
+    three.play(0, -1);
+    three.play(7 * 15 + 7, 1);
+    three.play(224, -1);
+    three.play(7 * 15 + 8, 1);
+    BoardSearch<Gomoku> search;
+    search.setEvaluator(&incremental);
+    SearchLimits limits;
+    limits.maxDepth = 2;
+    int block = search.bestMove(three, -1, limits);
+    QVERIFY(block == 7 * 15 + 5 || block == 7 * 15 + 9);
+    QVERIFY(search.lastSearch().score < 0 && search.lastSearch().score > -BoardSearch<Gomoku>::kWinScore);
+
+    // Root splitting and Lazy SMP score their leaves the same way
+    ParallelSearch<Gomoku> root_split(4);
+    root_split.usePatternEvaluation(true);
+    QCOMPARE(root_split.bestMove(three, -1, limits), block);
+    QCOMPARE(root_split.lastSearch().score, search.lastSearch().score);
+    LazySMPSearch<Gomoku> lazy(4, 1 << 16);
+    lazy.usePatternEvaluation(true);
+    int lazy_move = lazy.bestMove(three, -1, limits);
+    QVERIFY(lazy_move == 7 * 15 + 5 || lazy_move == 7 * 15 + 9);
+    QCOMPARE(lazy.lastSearch().score, search.lastSearch().score);
+
+    // YBWC with pattern evaluation gives the serial result
+    typedef MNKBoard<5, 5, 4> Board;
+    Board empty;
+    PatternEvaluator<Board> patterns;
+    BoardSearch<Board> serial;
+    serial.setEvaluator(&patterns);
+    YBWCSearch<Board> parallel(4);
+    parallel.usePatternEvaluation(true);
+    limits.maxDepth = 5;
+    QCOMPARE(parallel.bestMove(empty, 1, limits), serial.bestMove(empty, 1, limits));
+    QCOMPARE(parallel.lastSearch().score, serial.lastSearch().score);
+}
+
+void Tests::testSIMDLineScan() {
+    // Every kernel the CPU has counts the same windows as the scalar one,
+    // and the counts give the pattern table's score
+    typedef MNKBoard<15, 15, 5> Gomoku;
+    typedef MNKBoard<19, 19, 5> Go;
+    std::mt19937 rng(23);
+    const ScanKernel kernels[] = { ScanKernel::Scalar, ScanKernel::SSE41, ScanKernel::AVX2 };
+    ScanKernel detected = activeScanKernel();
+    QVERIFY(scanKernelSupported(ScanKernel::Scalar));
+    QVERIFY(scanKernelSupported(detected));
+    for (int trial = 0; trial < 20; trial++) {
+        Gomoku gomoku;
+        Go go;
+        int player = 1;
+        for (int ply = 0; ply < 20 + trial * 5; ply++) {
+            int cell;
+            do {
+                cell = int(rng() % 225);
+            } while (!gomoku.isEmpty(cell));
+            gomoku.play(cell, player);
+            do {
+                cell = int(rng() % 361);
+            } while (!go.isEmpty(cell));
+            go.play(cell, player);
+            player = -player;
+        }
+        LinePlanes small(15, 15, 5);
+        LinePlanes large(19, 19, 5);
+        small.load(gomoku);
+        large.load(go);
+        PatternEvaluator<Gomoku> small_patterns;
+        PatternEvaluator<Go> large_patterns;
+        small_patterns.reset(gomoku);
+        large_patterns.reset(go);
+
+        setScanKernel(ScanKernel::Scalar);
+        LineCounts small_scalar = small.scan();
+        LineCounts large_scalar = large.scan();
+        QCOMPARE(small_scalar.rawScore(), int64_t(small_patterns.rawScore()));
+        QCOMPARE(large_scalar.rawScore(), int64_t(large_patterns.rawScore()));
+        QCOMPARE(small_scalar.score(), small_patterns.score(1));
+        QCOMPARE(large_scalar.score(), large_patterns.score(1));
+        for (ScanKernel kernel : kernels) {
+            if (!scanKernelSupported(kernel)) {
+                continue;
+            }
+            setScanKernel(kernel);
+            QVERIFY(activeScanKernel() == kernel);
+            LineCounts small_counts = small.scan();
+            LineCounts large_counts = large.scan();
+            for (int side = 0; side < 2; side++) {
+                for (int n = 0; n <= 5; n++) {
+                    QCOMPARE(small_counts.windows[side][n], small_scalar.windows[side][n]);
+                    QCOMPARE(large_counts.windows[side][n], large_scalar.windows[side][n]);
+                }
+            }
+        }
+    }
+    setScanKernel(detected);
+
+    // An empty 15x15 board has 572 windows of five, all empty
+    LinePlanes planes(15, 15, 5);
+    QCOMPARE(planes.scan().windows[0][0], 572);
+    QCOMPARE(planes.lines() % 8, 0);
+
+    // O ahead, and long windows past the range of an int, stay exact and clamp
+    LineCounts counts = LineCounts();
+    counts.windows[1][2] = 3;
+    QCOMPARE(counts.rawScore(), int64_t(-12));
+    QCOMPARE(counts.score(), -12);
+    counts.windows[1][LineCounts::kMaxK] = 3;
+    QCOMPARE(counts.rawScore(), int64_t(-12) - 3 * (int64_t(1) << 30));
+    QCOMPARE(counts.score(), -PatternEvaluator<Gomoku>::kMaxScore);
+
+    // place and remove keep the planes in step with the board
+    planes.place(7 * 15 + 7, 1);
+    planes.place(7 * 15 + 8, 1);
+    planes.place(0, -1);
+    Gomoku board;
+    board.play(7 * 15 + 7, 1);
+    board.play(7 * 15 + 8, 1);
+    board.play(0, -1);
+    PatternEvaluator<Gomoku> patterns;
+    patterns.reset(board);
+    QCOMPARE(planes.scan().rawScore(), int64_t(patterns.rawScore()));
+    planes.remove(7 * 15 + 8, 1);
+    planes.remove(7 * 15 + 7, 1);
+    planes.remove(0, -1);
+    QCOMPARE(planes.scan().windows[0][0], 572);
+
+    // AIPlayer::evaluate keeps its scores on 3x3
+    AIPlayer ai;
+    GameBoard open = createBoard({{1, 0, 0}, {0, -1, 0}, {0, 0, 0}});
+    PatternEvaluator<GameBoard> reference;
+    reference.reset(open);
+    QCOMPARE(ai.evaluate(open), reference.score(-1));
+    QCOMPARE(ai.evaluate(createBoard({{-1, -1, -1}, {1, 1, 0}, {0, 0, 0}})), 1000);
+}
+
+void Tests::testBatchEvaluation() {
+    // Every 3x3 cell assignment, legal or not, scored in one batch
+    BoardBatch batch;
+    std::vector<GameBoard> boards;
+    for (int code = 0; code < 19683; code++) {
+        GameBoard board;
+        for (int cell = 0, rest = code; cell < 9; cell++, rest /= 3) {
+            if (rest % 3 != 0) {
+                board.setValue(cell / 3, cell % 3, rest % 3 == 1 ? 1 : -1);
+            }
+        }
+        batch.add(board);
+        boards.push_back(board);
+    }
+    QCOMPARE(int(batch.size()), 19683);
+
+    // Each kernel, single-threaded and split across a pool, agrees with
+    // checkWin and AIPlayer::evaluate board by board
+    AIPlayer ai;
+    ScanKernel detected = activeScanKernel();
+    const ScanKernel kernels[] = { ScanKernel::Scalar, ScanKernel::SSE41, ScanKernel::AVX2 };
+    BatchEvaluator pooled(4);
+    QCOMPARE(pooled.threads(), 4);
+    for (ScanKernel kernel : kernels) {
+        if (!scanKernelSupported(kernel)) {
+            continue;
+        }
+        setScanKernel(kernel);
+        std::vector<int8_t> outcomes(batch.size());
+        std::vector<int16_t> scores(batch.size());
+        pooled.evaluate(batch, outcomes.data(), scores.data());
+        std::vector<int8_t> range_outcomes(batch.size());
+        std::vector<int16_t> range_scores(batch.size());
+        // An odd count leaves a scalar tail after the vector steps
+        BatchEvaluator::evaluateRange(batch.xMasks.data(), batch.oMasks.data(), batch.size(), range_outcomes.data(),
+                                      range_scores.data());
+        for (size_t i = 0; i < boards.size(); i++) {
+            QCOMPARE(int(outcomes[i]), boards[i].checkWin());
+            QCOMPARE(int(scores[i]), ai.evaluate(boards[i]));
+            QCOMPARE(int(range_outcomes[i]), int(outcomes[i]));
+            QCOMPARE(int(range_scores[i]), int(scores[i]));
+        }
+    }
+    setScanKernel(detected);
+}
+
+void Tests::testNNUEEvaluation() {
+    typedef MNKBoard<15, 15, 5> Gomoku;
+    NNUEWeights weights;
+    weights.randomize(225, 25);
+
+    // Saved weights load back and give the same scores
+    const std::string path = "test_nnue_15x15.bin";
+    QVERIFY(weights.save(path));
+    NNUEWeights loaded;
+    QVERIFY(loaded.load(path));
+    QCOMPARE(loaded.cells(), 225);
+    std::remove(path.c_str());
+    QVERIFY(!loaded.load(path)); // Missing file
+    QCOMPARE(loaded.cells(), 225); // A failed load leaves the weights alone
+
+    // Incremental accumulators match a refresh through play and takeback,
+    // and every kernel computes the same dense layers
+    std::mt19937 rng(25);
+    Gomoku board;
+    NNUEEvaluator<Gomoku> incremental(&weights);
+    NNUEEvaluator<Gomoku> reloaded(&loaded);
+    NNUEEvaluator<Gomoku> refresh(&weights);
+    incremental.reset(board);
+    std::vector<int> played;
+    int player = 1;
+    ScanKernel detected = activeScanKernel();
+    const ScanKernel kernels[] = { ScanKernel::Scalar, ScanKernel::SSE41, ScanKernel::AVX2 };
+    for (int ply = 0; ply < 60; ply++) {
+        int cell;
+        do {
+            cell = int(rng() % 225);
+        } while (!board.isEmpty(cell));
+        board.play(cell, player);
+        incremental.place(cell, player);
+        played.push_back(cell);
+        player = -player;
+        refresh.reset(board);
+        reloaded.reset(board);
+        for (int i = 0; i < NNUEWeights::kHidden; i++) {
+            QCOMPARE(incremental.accumulatorFor(1)[i], refresh.accumulatorFor(1)[i]);
+            QCOMPARE(incremental.accumulatorFor(-1)[i], refresh.accumulatorFor(-1)[i]);
+        }
+        setScanKernel(ScanKernel::Scalar);
+        int expected = refresh.score(player);
+        QVERIFY(expected >= -NNUEEvaluator<Gomoku>::kMaxScore && expected <= NNUEEvaluator<Gomoku>::kMaxScore);
+        QCOMPARE(reloaded.score(player), expected);
+        for (ScanKernel kernel : kernels) {
+            if (scanKernelSupported(kernel)) {
+                setScanKernel(kernel);
+                QCOMPARE(incremental.score(player), expected);
+            }
+        }
+    }
+    setScanKernel(detected);
+    while (!played.empty()) {
+        int cell = played.back();
+        played.pop_back();
+        player = -player;
+        board.undo(cell);
+        incremental.remove(cell, player);
+    }
+    for (int i = 0; i < NNUEWeights::kHidden; i++) {
+        QCOMPARE(incremental.accumulatorFor(1)[i], weights.bias()[i]);
+    }
+
+    // Weights for another board size leave the evaluator silent
+    NNUEEvaluator<GameBoard> mismatched(&weights);
+    mismatched.reset(createBoard({{1, 0, 0}, {0, -1, 0}, {0, 0, 0}}));
+    QCOMPARE(mismatched.score(1), 0);
+
+    // AIPlayer takes only 9-cell networks, then scores unfinished boards with it
+    AIPlayer ai;
+    QVERIFY(weights.save(path));
+    QVERIFY(!ai.loadNetwork(path));
+    NNUEWeights small;
+    small.randomize(9, 7);
+    QVERIFY(small.save(path));
+    QVERIFY(ai.loadNetwork(path));
+    std::remove(path.c_str());
+    GameBoard open = createBoard({{1, 0, 0}, {0, -1, 0}, {0, 0, 0}});
+    PatternEvaluator<GameBoard> patterns;
+    patterns.reset(open);
+    QCOMPARE(ai.evaluate(open), patterns.score(-1)); // Patterns until selected
+    ai.setEvaluation(Evaluation::Network);
+    NNUEEvaluator<GameBoard> net(&small);
+    net.reset(open);
+    QCOMPARE(ai.evaluate(open), net.score(-1));
+    QCOMPARE(ai.evaluate(createBoard({{-1, -1, -1}, {1, 1, 0}, {0, 0, 0}})), 1000);
+    ai.makeMove(open);
+    int stones = 0;
+    for (int cell = 0; cell < 9; cell++) {
+        stones += open.getValue(cell / 3, cell % 3) != 0;
+    }
+    QCOMPARE(stones, 3);
+}
 
 void Tests::testPlayer1WinsRow() {
     GameBoard board;
@@ -359,6 +1671,53 @@ void Tests::testOutOfBoundsAccess() {
 }
 
 
+void Tests::testBitboardMasks() {
+    GameBoard board;
+    board.setValue(0, 0, 1);
+    board.setValue(1, 2, -1);
+    board.setValue(2, 1, 1);
+
+    // Bit (row * 3 + col) is set in the mask of the side owning the cell
+    QCOMPARE(int(board.mask(1)), (1 << 0) | (1 << 7));
+    QCOMPARE(int(board.mask(-1)), 1 << 5);
+
+    // Overwriting a cell moves its bit to the other side, clearing empties it
+    board.setValue(0, 0, -1);
+    QCOMPARE(int(board.mask(1)), 1 << 7);
+    QCOMPARE(int(board.mask(-1)), (1 << 0) | (1 << 5));
+    board.setValue(1, 2, 0);
+    QCOMPARE(int(board.mask(-1)), 1 << 0);
+}
+void Tests::testZobristHash() {
+    GameBoard empty;
+    QCOMPARE(empty.hash(), uint64_t(0));
+
+    // The same position reached through different move orders hashes the same
+    GameBoard a;
+    a.setValue(0, 0, 1);
+    a.setValue(1, 1, -1);
+    a.setValue(2, 2, 1);
+    GameBoard b;
+    b.setValue(2, 2, 1);
+    b.setValue(1, 1, -1);
+    b.setValue(0, 0, 1);
+    QCOMPARE(a.hash(), b.hash());
+
+    // Different owners of the same cell hash differently
+    GameBoard c;
+    c.setValue(0, 0, -1);
+    c.setValue(1, 1, -1);
+    c.setValue(2, 2, 1);
+    QVERIFY(a.hash() != c.hash());
+
+    // Overwriting and clearing cells restores the earlier hashes
+    c.setValue(0, 0, 1);
+    QCOMPARE(c.hash(), a.hash());
+    c.setValue(0, 0, 0);
+    c.setValue(1, 1, 0);
+    c.setValue(2, 2, 0);
+    QCOMPARE(c.hash(), empty.hash());
+}
 
 // Include the QTEST_MAIN macro to compile the unit tests
 QTEST_MAIN(Tests)
@@ -0,0 +1,40 @@
+QT -= core gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle qt
+
+TEMPLATE = app
+TARGET = benchmark
+
+SOURCES += \
+    ../tictactoegui/batcheval.cpp \
+    ../tictactoegui/gameboard.cpp \
+    ../tictactoegui/linescan.cpp \
+    ../tictactoegui/nnueeval.cpp \
+    ../tictactoegui/threadpool.cpp \
+    ../tictactoegui/transpositiontable.cpp \
+    main.cpp
+
+HEADERS += \
+    ../tictactoegui/batcheval.h \
+    ../tictactoegui/boardsearch.h \
+    ../tictactoegui/gameboard.h \
+    ../tictactoegui/leafeval.h \
+    ../tictactoegui/linescan.h \
+    ../tictactoegui/linewindows.h \
+    ../tictactoegui/mctssearch.h \
+    ../tictactoegui/mnkboard.h \
+    ../tictactoegui/moveordering.h \
+    ../tictactoegui/nnueeval.h \
+    ../tictactoegui/parallelmcts.h \
+    ../tictactoegui/parallelsearch.h \
+    ../tictactoegui/patterneval.h \
+    ../tictactoegui/proofsearch.h \
+    ../tictactoegui/threatsearch.h \
+    ../tictactoegui/threadpool.h \
+    ../tictactoegui/transpositiontable.h \
+    ../tictactoegui/workstealingdeque.h \
+    ../tictactoegui/ybwcsearch.h \
+    ../tictactoegui/zobrist.h
+
+unix: LIBS += -lpthread
@@ -0,0 +1,572 @@
+#include "../tictactoegui/batcheval.h"
+#include "../tictactoegui/boardsearch.h"
+#include "../tictactoegui/gameboard.h"
+#include "../tictactoegui/linescan.h"
+#include "../tictactoegui/mctssearch.h"
+#include "../tictactoegui/mnkboard.h"
+#include "../tictactoegui/nnueeval.h"
+#include "../tictactoegui/parallelmcts.h"
+#include "../tictactoegui/parallelsearch.h"
+#include "../tictactoegui/proofsearch.h"
+#include "../tictactoegui/threatsearch.h"
+#include "../tictactoegui/ybwcsearch.h"
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace {
+
+const char* algorithmName(SearchAlgorithm algorithm) {
+    if (algorithm == SearchAlgorithm::PVS) {
+        return "pvs";
+    } else if (algorithm == SearchAlgorithm::MTDF) {
+        return "mtd(f)";
+    }
+    return "alpha-beta";
+}
+
+// One iterative-deepening search from the empty board with a fresh engine
+template <class Board>
+void searchRow(const char* name, SearchAlgorithm algorithm, int maxDepth) {
+    Board board;
+    BoardSearch<Board> search(1 << 20);
+    search.setAlgorithm(algorithm);
+    SearchLimits limits;
+    limits.maxDepth = maxDepth;
+    auto start = std::chrono::steady_clock::now();
+    int cell = search.bestMove(board, 1, limits);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const SearchStats& stats = search.lastSearch();
+    std::cout << std::left << std::setw(16) << name << std::setw(12) << algorithmName(algorithm)
+              << std::right << std::setw(5) << stats.depth << std::setw(7) << stats.score
+              << std::setw(6) << cell << std::setw(12) << stats.nodes
+              << std::setw(10) << (algorithm == SearchAlgorithm::MTDF ? stats.passes : stats.researches)
+              << std::setw(9) << std::fixed << std::setprecision(3) << stats.firstMoveCutoffRate()
+              << std::setw(11) << std::setprecision(1) << ms << std::endl;
+}
+
+template <class Board>
+void compareAlgorithms(const char* name, int maxDepth) {
+    searchRow<Board>(name, SearchAlgorithm::AlphaBeta, maxDepth);
+    searchRow<Board>(name, SearchAlgorithm::PVS, maxDepth);
+    searchRow<Board>(name, SearchAlgorithm::MTDF, maxDepth);
+}
+
+void benchmarkSearch() {
+    std::cout << std::left << std::setw(16) << "board" << std::setw(12) << "algorithm"
+              << std::right << std::setw(5) << "depth" << std::setw(7) << "score"
+              << std::setw(6) << "move" << std::setw(12) << "nodes"
+              << std::setw(10) << "re/passes" << std::setw(9) << "first"
+              << std::setw(11) << "ms" << std::endl;
+    compareAlgorithms<GameBoard>("3x3 k3", 64);
+    compareAlgorithms<MNKBoard<4, 4, 3>>("4x4 k3", 64);
+    compareAlgorithms<MNKBoard<4, 4, 4>>("4x4 k4", 64);
+    compareAlgorithms<MNKBoard<5, 5, 4>>("5x5 k4 d7", 7);
+}
+
+// Root splitting at 1, 2, 4, ... threads up to twice the hardware threads
+void benchmarkParallel() {
+    const int kDepth = 7;
+    int hardware = int(std::max(1u, std::thread::hardware_concurrency()));
+    std::cout << "5x5 k4 depth " << kDepth << ", " << hardware << " hardware threads" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(6) << "move" << std::setw(12) << "nodes"
+              << std::setw(11) << "ms" << std::setw(9) << "speedup" << std::endl;
+    double serial_ms = 0;
+    for (int threads = 1; threads <= 2 * hardware || threads <= 4; threads *= 2) {
+        MNKBoard<5, 5, 4> board;
+        ParallelSearch<MNKBoard<5, 5, 4>> search(threads, 1 << 20);
+        SearchLimits limits;
+        limits.maxDepth = kDepth;
+        auto start = std::chrono::steady_clock::now();
+        int cell = search.bestMove(board, 1, limits);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1) {
+            serial_ms = ms;
+        }
+        std::cout << std::setw(8) << threads << std::setw(6) << cell << std::setw(12) << search.lastSearch().nodes
+                  << std::setw(11) << std::fixed << std::setprecision(1) << ms
+                  << std::setw(9) << std::setprecision(2) << serial_ms / ms << std::endl;
+    }
+}
+
+// Lazy SMP on a suite of 5x5 k4 openings, 1 to 64 threads; every run
+// starts from an empty shared table
+void benchmarkLazySMP() {
+    const int kDepth = 7;
+    const int kOpenings[][2] = { { -1, -1 }, { 12, -1 }, { 0, 12 }, { 6, 12 }, { 12, 7 } };
+    std::cout << "5x5 k4 depth " << kDepth << ", " << sizeof(kOpenings) / sizeof(kOpenings[0]) << " positions, "
+              << std::max(1u, std::thread::hardware_concurrency()) << " hardware threads" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "nodes" << std::setw(11) << "ms"
+              << std::setw(9) << "speedup" << std::endl;
+    double serial_ms = 0;
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        LazySMPSearch<MNKBoard<5, 5, 4>> search(threads);
+        uint64_t nodes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& opening : kOpenings) {
+            MNKBoard<5, 5, 4> board;
+            int player = 1;
+            for (int cell : opening) {
+                if (cell >= 0) {
+                    board.play(cell, player);
+                    player = -player;
+                }
+            }
+            search.clear();
+            SearchLimits limits;
+            limits.maxDepth = kDepth;
+            search.bestMove(board, player, limits);
+            nodes += search.lastSearch().nodes;
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1) {
+            serial_ms = ms;
+        }
+        std::cout << std::setw(8) << threads << std::setw(12) << nodes
+                  << std::setw(11) << std::fixed << std::setprecision(1) << ms
+                  << std::setw(9) << std::setprecision(2) << serial_ms / ms << std::endl;
+    }
+}
+
+// Young Brothers Wait with work stealing, 1 to 2x the hardware threads
+void benchmarkYBWC() {
+    const int kDepth = 7;
+    int hardware = int(std::max(1u, std::thread::hardware_concurrency()));
+    std::cout << "5x5 k4 depth " << kDepth << ", " << hardware << " hardware threads" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(10) << "ordering" << std::setw(12) << "nodes"
+              << std::setw(8) << "splits" << std::setw(8) << "steals" << std::setw(8) << "aborts"
+              << std::setw(8) << "first" << std::setw(11) << "ms" << std::setw(9) << "speedup" << std::endl;
+    double serial_ms = 0;
+    // One thread without ordering first, as the reference for the ordering gain
+    for (int threads = 0; threads <= 2 * hardware || threads <= 4; threads = std::max(1, threads * 2)) {
+        MNKBoard<5, 5, 4> board;
+        YBWCSearch<MNKBoard<5, 5, 4>> search(std::max(1, threads), 1 << 20);
+        search.setMoveOrdering(threads > 0);
+        SearchLimits limits;
+        limits.maxDepth = kDepth;
+        auto start = std::chrono::steady_clock::now();
+        search.bestMove(board, 1, limits);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1) {
+            serial_ms = ms;
+        }
+        const SearchStats& stats = search.lastSearch();
+        std::cout << std::setw(8) << std::max(1, threads) << std::setw(10) << (threads > 0 ? "on" : "off")
+                  << std::setw(12) << stats.nodes << std::setw(8) << stats.splits
+                  << std::setw(8) << stats.steals << std::setw(8) << stats.aborts
+                  << std::setw(8) << std::fixed << std::setprecision(3) << stats.firstMoveCutoffRate()
+                  << std::setw(11) << std::setprecision(1) << ms;
+        if (threads > 0) {
+            std::cout << std::setw(9) << std::setprecision(2) << serial_ms / ms;
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Playouts per second from a fixed time budget on the empty board
+template <class Board>
+void mctsRow(const char* name, int timeMs) {
+    Board board;
+    MCTSSearch<Board> search;
+    SearchLimits limits;
+    limits.timeMs = timeMs;
+    auto start = std::chrono::steady_clock::now();
+    int cell = search.bestMove(board, 1, limits);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const MCTSStats& stats = search.lastSearch();
+    std::cout << std::left << std::setw(16) << name << std::right << std::setw(6) << cell
+              << std::setw(12) << stats.playouts << std::setw(10) << stats.treeNodes
+              << std::setw(9) << std::fixed << std::setprecision(3) << stats.winRate
+              << std::setw(11) << std::setprecision(1) << ms
+              << std::setw(14) << std::setprecision(0) << stats.playouts * 1000.0 / ms << std::endl;
+}
+
+void benchmarkMCTS() {
+    std::cout << std::left << std::setw(16) << "board" << std::right << std::setw(6) << "move"
+              << std::setw(12) << "playouts" << std::setw(10) << "nodes" << std::setw(9) << "win"
+              << std::setw(11) << "ms" << std::setw(14) << "playouts/s" << std::endl;
+    mctsRow<GameBoard>("3x3 k3", 500);
+    mctsRow<MNKBoard<5, 5, 4>>("5x5 k4", 500);
+    mctsRow<MNKBoard<15, 15, 5>>("15x15 k5", 1000);
+
+    // Tree-parallel MCTS: total playout rate per thread count
+    const int kTimeMs = 1000;
+    int hardware = int(std::max(1u, std::thread::hardware_concurrency()));
+    std::cout << std::endl << "15x15 k5 parallel, " << kTimeMs << " ms, " << hardware << " hardware threads" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(12) << "playouts" << std::setw(10) << "nodes"
+              << std::setw(14) << "playouts/s" << std::setw(9) << "speedup" << std::endl;
+    double serial_rate = 0;
+    for (int threads = 1; threads <= 2 * hardware || threads <= 4; threads *= 2) {
+        MNKBoard<15, 15, 5> board;
+        ParallelMCTSSearch<MNKBoard<15, 15, 5>> search(threads);
+        SearchLimits limits;
+        limits.timeMs = kTimeMs;
+        auto start = std::chrono::steady_clock::now();
+        search.bestMove(board, 1, limits);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const MCTSStats& stats = search.lastSearch();
+        double rate = stats.playouts * 1000.0 / ms;
+        if (threads == 1) {
+            serial_rate = rate;
+        }
+        std::cout << std::setw(8) << threads << std::setw(12) << stats.playouts << std::setw(10) << stats.treeNodes
+                  << std::setw(14) << std::fixed << std::setprecision(0) << rate
+                  << std::setw(9) << std::setprecision(2) << rate / serial_rate << std::endl;
+    }
+}
+
+const char* resultName(ProofResult result) {
+    if (result == ProofResult::Win) {
+        return "win";
+    } else if (result == ProofResult::Loss) {
+        return "loss";
+    } else if (result == ProofResult::Draw) {
+        return "draw";
+    }
+    return "unknown";
+}
+
+// df-pn next to a full-width alpha-beta solve of the same position
+template <class Board>
+void proofRow(const char* name, Board board) {
+    SearchLimits limits;
+    limits.timeMs = 30000;
+    ProofSearch<Board> solver;
+    auto start = std::chrono::steady_clock::now();
+    ProofResult result = solver.solve(board, 1, limits);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    BoardSearch<Board> search(1 << 20);
+    start = std::chrono::steady_clock::now();
+    search.bestMove(board, 1, limits);
+    double ab_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const ProofStats& stats = solver.lastSearch();
+    std::cout << std::left << std::setw(18) << name << std::setw(9) << resultName(result) << std::right
+              << std::setw(6) << solver.bestMove() << std::setw(11) << stats.nodes << std::setw(6) << stats.gcRuns
+              << std::setw(11) << std::fixed << std::setprecision(1) << ms
+              << std::setw(12) << search.lastSearch().nodes << std::setw(11) << ab_ms << std::endl;
+}
+
+void benchmarkProof() {
+    std::cout << std::left << std::setw(18) << "position" << std::setw(9) << "result" << std::right
+              << std::setw(6) << "move" << std::setw(11) << "pn nodes" << std::setw(6) << "gc"
+              << std::setw(11) << "pn ms" << std::setw(12) << "ab nodes" << std::setw(11) << "ab ms" << std::endl;
+    proofRow("4x4 k3 empty", MNKBoard<4, 4, 3>());
+    proofRow("4x4 k4 empty", MNKBoard<4, 4, 4>());
+    // X to move with an open three on row 7
+    MNKBoard<15, 15, 5> three;
+    three.play(7 * 15 + 6, 1);
+    three.play(0, -1);
+    three.play(7 * 15 + 7, 1);
+    three.play(14, -1);
+    three.play(7 * 15 + 8, 1);
+    three.play(224, -1);
+    proofRow("15x15 k5 three", three);
+    // Four on row 7, then an open four on column 4: five plies
+    MNKBoard<15, 15, 5> fours;
+    for (int cell : {7 * 15 + 1, 7 * 15 + 2, 7 * 15 + 3, 8 * 15 + 4, 9 * 15 + 4}) {
+        fours.play(cell, 1);
+    }
+    for (int cell : {7 * 15, 14, 14 * 15, 14 * 15 + 14, 2 * 15 + 10}) {
+        fours.play(cell, -1);
+    }
+    proofRow("15x15 k5 fours", fours);
+}
+
+void threatRow(const char* name, const MNKBoard<15, 15, 5>& board) {
+    ThreatSearch<MNKBoard<15, 15, 5>> threats;
+    auto start = std::chrono::steady_clock::now();
+    int cell = threats.findWin(board, 1);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const ThreatStats& stats = threats.lastSearch();
+    std::cout << std::left << std::setw(18) << name << std::right << std::setw(6) << cell
+              << std::setw(7) << stats.depth << std::setw(5) << (stats.vct ? "vct" : cell == -1 ? "-" : "vcf")
+              << std::setw(9) << stats.nodes << std::setw(10) << std::fixed << std::setprecision(2) << ms << std::endl;
+}
+
+// Threat-space search on 15x15 k5 positions, X to move
+void benchmarkThreats() {
+    std::cout << std::left << std::setw(18) << "position" << std::right << std::setw(6) << "move"
+              << std::setw(7) << "depth" << std::setw(5) << "kind" << std::setw(9) << "nodes"
+              << std::setw(10) << "ms" << std::endl;
+    MNKBoard<15, 15, 5> fours;
+    for (int cell : {7 * 15 + 1, 7 * 15 + 2, 7 * 15 + 3, 8 * 15 + 4, 9 * 15 + 4}) {
+        fours.play(cell, 1);
+    }
+    for (int cell : {7 * 15, 14, 14 * 15, 14 * 15 + 14, 2 * 15 + 10}) {
+        fours.play(cell, -1);
+    }
+    threatRow("fours", fours);
+    // Two twos that (7, 8) turns into a double open three
+    MNKBoard<15, 15, 5> fork;
+    for (int cell : {7 * 15 + 6, 7 * 15 + 7, 5 * 15 + 8, 6 * 15 + 8}) {
+        fork.play(cell, 1);
+    }
+    for (int cell : {0, 14, 14 * 15, 14 * 15 + 14}) {
+        fork.play(cell, -1);
+    }
+    threatRow("fork", fork);
+    MNKBoard<15, 15, 5> quiet;
+    quiet.play(112, 1);
+    quiet.play(113, -1);
+    threatRow("quiet", quiet);
+}
+
+// Full evaluations per second of random positions: the pattern table
+// rescanning the board, then each line-scan kernel over the same positions
+template <class Board>
+void scanRows(const char* name) {
+    const int kPositions = 64;
+    const int kRounds = 2000;
+    std::mt19937 rng(23);
+    std::vector<Board> boards(kPositions);
+    for (Board& board : boards) {
+        int player = 1;
+        for (int ply = 0; ply < board.cells() / 4; ply++) {
+            int cell;
+            do {
+                cell = int(rng() % unsigned(board.cells()));
+            } while (!board.isEmpty(cell));
+            board.play(cell, player);
+            player = -player;
+        }
+    }
+    long long checksum = 0;
+    PatternEvaluator<Board> patterns;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < kRounds / 10; round++) {
+        for (const Board& board : boards) {
+            patterns.reset(board);
+            checksum += patterns.rawScore();
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::left << std::setw(12) << name << std::setw(10) << "pattern" << std::right
+              << std::setw(14) << std::fixed << std::setprecision(0) << kPositions * (kRounds / 10) * 1000.0 / ms
+              << std::setw(9) << "-" << std::endl;
+
+    std::vector<LinePlanes> planes(kPositions, LinePlanes(Board::rows(), Board::cols(), Board::k()));
+    for (int i = 0; i < kPositions; i++) {
+        planes[size_t(i)].load(boards[size_t(i)]);
+    }
+    ScanKernel detected = activeScanKernel();
+    const ScanKernel kernels[] = { ScanKernel::Scalar, ScanKernel::SSE41, ScanKernel::AVX2 };
+    const char* names[] = { "scalar", "sse4.1", "avx2" };
+    double scalar_rate = 0;
+    for (int i = 0; i < 3; i++) {
+        if (!scanKernelSupported(kernels[i])) {
+            std::cout << std::left << std::setw(12) << name << std::setw(10) << names[i] << std::right
+                      << std::setw(14) << "unsupported" << std::endl;
+            continue;
+        }
+        setScanKernel(kernels[i]);
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < kRounds; round++) {
+            for (const LinePlanes& position : planes) {
+                checksum += position.scan().score();
+            }
+        }
+        ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        double rate = kPositions * kRounds * 1000.0 / ms;
+        if (i == 0) {
+            scalar_rate = rate;
+        }
+        std::cout << std::left << std::setw(12) << name << std::setw(10) << names[i] << std::right
+                  << std::setw(14) << std::setprecision(0) << rate
+                  << std::setw(9) << std::setprecision(2) << rate / scalar_rate << std::endl;
+    }
+    setScanKernel(detected);
+    if (checksum == 42) {
+        std::cout << std::endl; // Keeps the loops from being optimized away
+    }
+}
+
+void benchmarkScan() {
+    std::cout << std::left << std::setw(12) << "board" << std::setw(10) << "kernel" << std::right
+              << std::setw(14) << "evals/s" << std::setw(9) << "speedup" << std::endl;
+    scanRows<MNKBoard<15, 15, 5>>("15x15 k5");
+    scanRows<MNKBoard<19, 19, 5>>("19x19 k5");
+}
+
+// Boards per second: one checkWin plus evaluate-style line scan per board,
+// then the batch API per kernel and per thread count
+void benchmarkBatch() {
+    const size_t kBoards = 1 << 20;
+    const int kRounds = 20;
+    std::mt19937 rng(24);
+    BoardBatch batch;
+    std::vector<GameBoard> boards;
+    for (size_t i = 0; i < kBoards; i++) {
+        GameBoard board;
+        int player = 1;
+        int stones = int(rng() % 10);
+        for (int ply = 0; ply < stones; ply++) {
+            int cell;
+            do {
+                cell = int(rng() % 9);
+            } while (!board.isEmpty(cell));
+            board.play(cell, player);
+            player = -player;
+        }
+        batch.add(board);
+        boards.push_back(board);
+    }
+    std::vector<int8_t> outcomes(kBoards);
+    std::vector<int16_t> scores(kBoards);
+    long long checksum = 0;
+
+    std::cout << std::left << std::setw(12) << "kernel" << std::right << std::setw(8) << "threads"
+              << std::setw(14) << "boards/s" << std::setw(9) << "speedup" << std::endl;
+    LinePlanes planes(3, 3, 3);
+    auto start = std::chrono::steady_clock::now();
+    for (const GameBoard& board : boards) {
+        int result = board.checkWin();
+        if (result == 0) {
+            planes.load(board);
+            result = planes.scan().score();
+        }
+        checksum += result;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    double single_rate = kBoards * 1000.0 / ms;
+    std::cout << std::left << std::setw(12) << "per board" << std::right << std::setw(8) << 1
+              << std::setw(14) << std::fixed << std::setprecision(0) << single_rate
+              << std::setw(9) << std::setprecision(2) << 1.0 << std::endl;
+
+    ScanKernel detected = activeScanKernel();
+    const ScanKernel kernels[] = { ScanKernel::Scalar, ScanKernel::SSE41, ScanKernel::AVX2 };
+    const char* names[] = { "scalar", "sse4.1", "avx2" };
+    int hardware = int(std::max(1u, std::thread::hardware_concurrency()));
+    for (int i = 0; i < 3; i++) {
+        if (!scanKernelSupported(kernels[i])) {
+            continue;
+        }
+        setScanKernel(kernels[i]);
+        // Thread scaling for the best kernel only
+        int max_threads = kernels[i] == detected ? std::max(4, 2 * hardware) : 1;
+        for (int threads = 1; threads <= max_threads; threads *= 2) {
+            BatchEvaluator evaluator(threads);
+            start = std::chrono::steady_clock::now();
+            for (int round = 0; round < kRounds; round++) {
+                evaluator.evaluate(batch, outcomes.data(), scores.data());
+                checksum += scores[size_t(round)];
+            }
+            ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            double rate = kBoards * kRounds * 1000.0 / ms;
+            std::cout << std::left << std::setw(12) << names[i] << std::right << std::setw(8) << threads
+                      << std::setw(14) << std::setprecision(0) << rate
+                      << std::setw(9) << std::setprecision(2) << rate / single_rate << std::endl;
+        }
+    }
+    setScanKernel(detected);
+    std::cout << hardware << " hardware threads" << std::endl;
+    if (checksum == 42) {
+        std::cout << std::endl; // Keeps the loops from being optimized away
+    }
+}
+
+// Leaf evaluations per second on 15x15 k5: one place, score and remove per
+// evaluation, as a search does at its leaves, for the pattern table and
+// the NNUE network per kernel (random weights; speed only)
+template <class Evaluator>
+double leafRate(Evaluator& evaluator, const std::vector<MNKBoard<15, 15, 5>>& boards, long long& checksum) {
+    const int kRounds = 2000;
+    auto start = std::chrono::steady_clock::now();
+    int evaluations = 0;
+    for (const MNKBoard<15, 15, 5>& board : boards) {
+        evaluator.reset(board);
+        for (int round = 0; round < kRounds; round++) {
+            int cell = round % 225;
+            if (board.isEmpty(cell)) {
+                evaluator.place(cell, -1);
+                checksum += evaluator.score(1);
+                evaluator.remove(cell, -1);
+                evaluations++;
+            }
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return evaluations * 1000.0 / ms;
+}
+
+void benchmarkNNUE() {
+    typedef MNKBoard<15, 15, 5> Gomoku;
+    std::mt19937 rng(25);
+    std::vector<Gomoku> boards(64);
+    for (Gomoku& board : boards) {
+        int player = 1;
+        for (int ply = 0; ply < 40; ply++) {
+            int cell;
+            do {
+                cell = int(rng() % 225);
+            } while (!board.isEmpty(cell));
+            board.play(cell, player);
+            player = -player;
+        }
+    }
+    long long checksum = 0;
+    std::cout << std::left << std::setw(18) << "evaluator" << std::right << std::setw(14) << "evals/s"
+              << std::setw(9) << "relative" << std::endl;
+    PatternEvaluator<Gomoku> patterns;
+    double pattern_rate = leafRate(patterns, boards, checksum);
+    std::cout << std::left << std::setw(18) << "pattern table" << std::right
+              << std::setw(14) << std::fixed << std::setprecision(0) << pattern_rate
+              << std::setw(9) << std::setprecision(2) << 1.0 << std::endl;
+
+    NNUEWeights weights;
+    weights.randomize(225, 25);
+    NNUEEvaluator<Gomoku> network(&weights);
+    ScanKernel detected = activeScanKernel();
+    const ScanKernel kernels[] = { ScanKernel::Scalar, ScanKernel::SSE41, ScanKernel::AVX2 };
+    const char* names[] = { "nnue scalar", "nnue sse4.1", "nnue avx2" };
+    for (int i = 0; i < 3; i++) {
+        if (!scanKernelSupported(kernels[i])) {
+            continue;
+        }
+        setScanKernel(kernels[i]);
+        double rate = leafRate(network, boards, checksum);
+        std::cout << std::left << std::setw(18) << names[i] << std::right
+                  << std::setw(14) << std::setprecision(0) << rate
+                  << std::setw(9) << std::setprecision(2) << rate / pattern_rate << std::endl;
+    }
+    setScanKernel(detected);
+    if (checksum == 42) {
+        std::cout << std::endl; // Keeps the loops from being optimized away
+    }
+}
+
+} // namespace
+
+// Search benchmarks on the empty board.
+// Usage: benchmark [search|parallel|smp|ybwc|mcts|proof|threats|scan|batch|nnue]
+int main(int argc, char *argv[])
+{
+    const char* which = argc > 1 ? argv[1] : "search";
+    if (std::strcmp(which, "search") == 0) {
+        benchmarkSearch();
+    } else if (std::strcmp(which, "parallel") == 0) {
+        benchmarkParallel();
+    } else if (std::strcmp(which, "smp") == 0) {
+        benchmarkLazySMP();
+    } else if (std::strcmp(which, "ybwc") == 0) {
+        benchmarkYBWC();
+    } else if (std::strcmp(which, "mcts") == 0) {
+        benchmarkMCTS();
+    } else if (std::strcmp(which, "proof") == 0) {
+        benchmarkProof();
+    } else if (std::strcmp(which, "threats") == 0) {
+        benchmarkThreats();
+    } else if (std::strcmp(which, "scan") == 0) {
+        benchmarkScan();
+    } else if (std::strcmp(which, "batch") == 0) {
+        benchmarkBatch();
+    } else if (std::strcmp(which, "nnue") == 0) {
+        benchmarkNNUE();
+    } else {
+        std::cerr << "usage: " << argv[0] << " [search|parallel|smp|ybwc|mcts|proof|threats|scan|batch|nnue]" << std::endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include "../tictactoegui/tablebase.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+// Offline retrograde solver for m,n,k boards of up to 32 cells.
+// Usage: tablebasegen <rows> <cols> <k> <output> [threads] [tempdir]
+int main(int argc, char *argv[])
+{
+    if (argc < 5) {
+        std::cerr << "usage: " << argv[0] << " <rows> <cols> <k> <output> [threads] [tempdir]" << std::endl;
+        return 2;
+    }
+    TablebaseOptions options;
+    options.rows = std::atoi(argv[1]);
+    options.cols = std::atoi(argv[2]);
+    options.k = std::atoi(argv[3]);
+    options.path = argv[4];
+    if (argc > 5) {
+        options.threads = std::atoi(argv[5]);
+    }
+    if (argc > 6) {
+        options.tempDir = argv[6];
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::string error;
+    if (!generateTablebase(options, &error)) {
+        std::cerr << "tablebasegen: " << error << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Tablebase tablebase;
+    if (!tablebase.open(options.path)) {
+        std::cerr << "tablebasegen: cannot read back " << options.path << std::endl;
+        return 1;
+    }
+    const char* names[] = { "loss", "draw", "win", "unknown" };
+    std::cout << options.rows << "x" << options.cols << " k=" << options.k
+              << ": empty board is a " << names[tablebase.probe(0, 0)] << " for the first player ("
+              << seconds << " s)" << std::endl;
+    return 0;
+}
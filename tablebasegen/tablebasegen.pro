@@ -0,0 +1,17 @@
+QT -= core gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle qt
+
+TEMPLATE = app
+TARGET = tablebasegen
+
+SOURCES += \
+    ../tictactoegui/tablebase.cpp \
+    main.cpp
+
+HEADERS += \
+    ../tictactoegui/bitops.h \
+    ../tictactoegui/tablebase.h
+
+unix: LIBS += -lpthread
@@ -1,31 +1,199 @@
 #include "aiplayer.h"
 #include "gameboard.h"
+#include <algorithm>
 #include <limits>
 #include <iostream>
+#include <thread>
+#include <utility>
 
-void AIPlayer::makeMove(GameBoard& board) const {
+AIPlayer::AIPlayer() {
+    mtdEngine.setAlgorithm(SearchAlgorithm::MTDF);
+    engine.setEvaluator(&heuristic); // MTD(f) keeps the three-valued leaves it converges on quickly
+}
+
+void AIPlayer::makeMove(GameBoard& board) {
     std::cout << "AI Move:" << std::endl;
-    TreeNode* root = new TreeNode;
-    root->board = board;
-    build_tree(root, -1); // AI is player -1
-
-    int best_score = std::numeric_limits<int>::min();
-    TreeNode* best_move = nullptr;
-    for (TreeNode* child : root->children) {
-        int score = minimax(child, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), false, 9); // Adjust depth of search
-        if (score > best_score) {
-            best_score = score;
-            best_move = child;
+
+    int best_cell = bestMoveFromFile(board); // On-disk tablebase, when loaded
+    if (best_cell == -1) {
+        best_cell = bestMoveFromThreats(board); // VCF/VCT pre-pass
+    }
+    if (best_cell == -1) {
+        if (searchMode == SearchMode::GameTree) {
+            best_cell = bestMoveFromTree(board);
+        } else if (searchMode == SearchMode::Tablebase) {
+            best_cell = bestMoveFromTablebase(board);
+        } else if (searchMode == SearchMode::MTDF) {
+            best_cell = bestMoveFromMTDF(board);
+        } else if (searchMode == SearchMode::ParallelRoot) {
+            best_cell = bestMoveFromParallel(board);
+        } else if (searchMode == SearchMode::LazySMP) {
+            best_cell = bestMoveFromLazySMP(board);
+        } else if (searchMode == SearchMode::MCTS) {
+            best_cell = bestMoveFromMCTS(board);
+        } else if (searchMode == SearchMode::ParallelMCTS) {
+            best_cell = bestMoveFromParallelMCTS(board);
+        } else {
+            best_cell = bestMoveFromSearch(board);
+        }
+    }
+    if (best_cell != -1) {
+        board.setValue(best_cell / 3, best_cell % 3, -1); // AI's move
+    }
+}
+
+int AIPlayer::bestMoveFromThreats(const GameBoard& board) {
+    if (difficulty == Difficulty::Easy) {
+        return -1; // Easy is meant to miss things
+    }
+    // A tenth of the move's budget: a forced win is found quickly or not at all
+    SearchLimits limits;
+    limits.timeMs = std::max(1, limitsFor(difficulty).timeMs / 10);
+    return threats.findWin(board, -1, limits);
+}
+
+int AIPlayer::bestMoveFromTree(const GameBoard& board) {
+    uint32_t root = tree.build(board, -1); // AI is player -1
+    if (tree.node(root).childCount == 0) {
+        return -1;
+    }
+    const GameTree::Node& best = tree.node(tree.bestChild(root, true));
+    return best.moveRow * 3 + best.moveCol;
+}
+
+int AIPlayer::bestMoveFromSearch(GameBoard& board) {
+    // YBWC workers keep pattern tables of their own, so the network runs serially
+    if (std::thread::hardware_concurrency() > 1 && !usingNetwork()) {
+        // Same search spread over all cores, on the engine's table
+        if (!ybwc) {
+            ybwc.reset(new YBWCSearch<GameBoard>(0, 1));
+            ybwc->shareTable(&engine.table);
+            ybwc->usePatternEvaluation(true); // Same leaf scores as the engine
+        }
+        return ybwc->bestMove(board, -1, limitsFor(difficulty));
+    }
+    return engine.bestMove(board, -1, limitsFor(difficulty)); // AI is player -1
+}
+
+int AIPlayer::bestMoveFromMTDF(GameBoard& board) {
+    return mtdEngine.bestMove(board, -1, limitsFor(difficulty));
+}
+
+int AIPlayer::bestMoveFromParallel(const GameBoard& board) {
+    if (!parallel) {
+        parallel.reset(new ParallelSearch<GameBoard>());
+        parallel->usePatternEvaluation(true); // Same leaf scores as the engine
+    }
+    return parallel->bestMove(board, -1, limitsFor(difficulty));
+}
+
+int AIPlayer::bestMoveFromLazySMP(const GameBoard& board) {
+    if (!lazySMP) {
+        lazySMP.reset(new LazySMPSearch<GameBoard>(0, 1 << 16));
+        lazySMP->usePatternEvaluation(true);
+    }
+    return lazySMP->bestMove(board, -1, limitsFor(difficulty));
+}
+
+int AIPlayer::bestMoveFromMCTS(const GameBoard& board) {
+    return mcts.bestMove(board, -1, mctsLimitsFor(difficulty));
+}
+
+int AIPlayer::bestMoveFromParallelMCTS(const GameBoard& board) {
+    if (!parallelMCTS) {
+        parallelMCTS.reset(new ParallelMCTSSearch<GameBoard>(0, 1 << 16));
+    }
+    return parallelMCTS->bestMove(board, -1, mctsLimitsFor(difficulty));
+}
+
+SearchLimits AIPlayer::limitsFor(Difficulty level) {
+    SearchLimits limits;
+    if (level == Difficulty::Easy) {
+        limits.maxDepth = 2;
+        limits.timeMs = 50;
+    } else if (level == Difficulty::Medium) {
+        limits.maxDepth = 4;
+        limits.timeMs = 200;
+    } else {
+        limits.timeMs = 1000;
+    }
+    return limits;
+}
+
+SearchLimits AIPlayer::mctsLimitsFor(Difficulty level) {
+    SearchLimits limits;
+    if (level == Difficulty::Easy) {
+        limits.nodes = 300;
+        limits.timeMs = 50;
+    } else if (level == Difficulty::Medium) {
+        limits.nodes = 5000;
+        limits.timeMs = 200;
+    } else {
+        limits.timeMs = 1000;
+    }
+    return limits;
+}
+
+int AIPlayer::bestMoveFromTablebase(GameBoard& board) {
+    PerfectPlay play = perfectPlay(board, -1); // AI is player -1
+    if (!play.known) {
+        return bestMoveFromSearch(board); // Position cannot arise in a real game
+    }
+    for (int cell = 0; cell < 9; cell++) {
+        if (play.moves & (1 << cell)) {
+            return cell;
         }
     }
+    return -1; // Game already over
+}
+
+int AIPlayer::bestMoveFromFile(const GameBoard& board) const {
+    if (!tablebase.isOpen()) {
+        return -1;
+    }
+    // Player 1 opens, so the AI is the second player in the file's terms
+    return tablebase.bestMove(board.mask(1), board.mask(-1));
+}
+
+bool AIPlayer::loadTablebase(const std::string& path) {
+    if (!tablebase.open(path)) {
+        return false;
+    }
+    const TablebaseIndex* index = tablebase.index();
+    if (index->rows() != 3 || index->cols() != 3 || index->k() != 3) {
+        tablebase.close();
+        return false;
+    }
+    return true;
+}
+
+bool AIPlayer::loadNetwork(const std::string& path) {
+    NNUEWeights loaded;
+    if (!loaded.load(path) || loaded.cells() != GameBoard::kCells) {
+        return false;
+    }
+    networkWeights = std::move(loaded);
+    engine.clear(); // Stored scores came from the old leaf values
+    setEvaluation(evaluation);
+    return true;
+}
 
-    board.setValue(best_move->moveRow, best_move->moveCol, -1); // AI's move
+void AIPlayer::setEvaluation(Evaluation kind) {
+    evaluation = kind;
+    if (usingNetwork()) {
+        engine.setEvaluator(&network);
+    } else {
+        engine.setEvaluator(&heuristic);
+    }
+}
 
-    // Free memory
-    for (TreeNode* child : root->children) {
-        delete child;
+void AIPlayer::newGame() {
+    engine.clear();
+    mtdEngine.clear();
+    mcts.reset();
+    if (lazySMP) {
+        lazySMP->clear();
     }
-    delete root;
 }
 
 void AIPlayer::build_tree(TreeNode* node, int player) const {
@@ -90,6 +258,12 @@ int AIPlayer::evaluate(const GameBoard& board) const {
     } else if (result == 2) { // If it's a draw, return 0
         return 0;
     }
-    // Otherwise, return a neutral score
-    return 0;
+    // Otherwise, estimate for the AI with the network or the line patterns
+    if (usingNetwork()) {
+        NNUEEvaluator<GameBoard> net(&networkWeights);
+        net.reset(board);
+        return net.score(-1);
+    }
+    planes.load(board);
+    return -planes.scan().score(); // Already within +-kMaxScore
 }
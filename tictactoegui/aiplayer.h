@@ -1,7 +1,20 @@
 #ifndef AIPLAYER_H
 #define AIPLAYER_H
 
+#include "boardsearch.h"
 #include "gameboard.h"
+#include "gametree.h"
+#include "linescan.h"
+#include "mctssearch.h"
+#include "nnueeval.h"
+#include "parallelmcts.h"
+#include "parallelsearch.h"
+#include "perfectplay.h"
+#include "tablebase.h"
+#include "threatsearch.h"
+#include "ybwcsearch.h"
+#include <memory>
+#include <string>
 #include <vector>
 
 struct TreeNode {
@@ -12,16 +25,85 @@ struct TreeNode {
     int score;
 
     TreeNode() : moveRow(-1), moveCol(-1), score(0) {}
+    ~TreeNode() {
+        for (TreeNode* child : children) {
+            delete child;
+        }
+    }
+    TreeNode(const TreeNode&) = delete;
+    TreeNode& operator=(const TreeNode&) = delete;
+};
+
+enum class SearchMode {
+    MakeUnmake, // Generate moves on the fly on a single board (default)
+    GameTree,   // Materialize the full game tree in an arena and pick from it
+    Tablebase,  // Look the move up in the compile-time perfect-play table
+    MTDF,       // Converge on the value with MTD(f) zero-window searches
+    ParallelRoot, // Split the root moves across a pool of worker threads
+    LazySMP,    // All threads search the root, sharing one lock-free table
+    MCTS,       // Monte Carlo Tree Search, keeping its tree between moves
+    ParallelMCTS // MCTS on all cores over one shared tree
+};
+
+// Heuristic for unfinished positions, in evaluate and at depth-limited leaves
+enum class Evaluation {
+    Patterns, // Line-window pattern table (default)
+    Network   // NNUE network from loadNetwork; patterns until one is loaded
+};
+
+// Each level caps how deep and how long the AI may think per move
+enum class Difficulty {
+    Easy,   // 2 plies, 50 ms
+    Medium, // 4 plies, 200 ms
+    Hard    // unlimited depth, 1 s
 };
 
 class AIPlayer {
 public:
-    void makeMove(GameBoard& board) const;
+    AIPlayer();
+    void makeMove(GameBoard& board);
+    void newGame(); // Forget cached positions from the previous game
+    void setSearchMode(SearchMode mode) { searchMode = mode; }
+    void setDifficulty(Difficulty level) { difficulty = level; }
+    static SearchLimits limitsFor(Difficulty level);
+    static SearchLimits mctsLimitsFor(Difficulty level); // Playouts and time per move
+    bool loadTablebase(const std::string& path); // 3x3, k = 3 file from generateTablebase
+    bool loadNetwork(const std::string& path); // 9-cell NNUEWeights file
+    void setEvaluation(Evaluation kind);
 
 private:
     void build_tree(TreeNode* node, int player) const;
     int minimax(TreeNode* node, int alpha, int beta, bool is_max, int depth) const;
     int evaluate(const GameBoard& board) const;
+    int bestMoveFromTree(const GameBoard& board);
+    int bestMoveFromSearch(GameBoard& board);
+    int bestMoveFromMTDF(GameBoard& board);
+    int bestMoveFromParallel(const GameBoard& board);
+    int bestMoveFromLazySMP(const GameBoard& board);
+    int bestMoveFromMCTS(const GameBoard& board);
+    int bestMoveFromParallelMCTS(const GameBoard& board);
+    int bestMoveFromTablebase(GameBoard& board);
+    int bestMoveFromFile(const GameBoard& board) const;
+    int bestMoveFromThreats(const GameBoard& board);
+    bool usingNetwork() const { return evaluation == Evaluation::Network && networkWeights.isLoaded(); }
+
+    BoardSearch<GameBoard> engine; // Its table survives across makeMove calls within a game
+    BoardSearch<GameBoard> mtdEngine; // MTD(f) passes, with a table of their own
+    std::unique_ptr<ParallelSearch<GameBoard>> parallel; // Threads start on first use
+    std::unique_ptr<LazySMPSearch<GameBoard>> lazySMP;   // Likewise
+    std::unique_ptr<YBWCSearch<GameBoard>> ybwc; // MakeUnmake on multi-core machines
+    PatternEvaluator<GameBoard> heuristic; // Scores engine's depth-limited leaves
+    NNUEWeights networkWeights;
+    NNUEEvaluator<GameBoard> network{&networkWeights}; // Takes heuristic's place with Evaluation::Network
+    Evaluation evaluation = Evaluation::Patterns;
+    mutable LinePlanes planes{3, 3, 3}; // evaluate's scratch bitplanes, built once
+    MCTSSearch<GameBoard> mcts{1 << 16}; // 3x3 trees are tiny
+    std::unique_ptr<ParallelMCTSSearch<GameBoard>> parallelMCTS; // Threads start on first use
+    SearchMode searchMode = SearchMode::MakeUnmake;
+    Difficulty difficulty = Difficulty::Hard;
+    GameTree tree; // Arena reused by the GameTree mode, reset on every move
+    Tablebase tablebase; // Probed before any search when loaded
+    ThreatSearch<GameBoard> threats; // Forced wins, tried before the regular search
     friend class Tests;
 };
 
@@ -0,0 +1,200 @@
+#include "batcheval.h"
+#include "bitops.h"
+#include "linescan.h"
+#include "patterneval.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BATCHEVAL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const uint16_t kLines[8] = { 0x007, 0x038, 0x1C0, 0x049, 0x092, 0x124, 0x111, 0x054 };
+const uint16_t kFull = 0x1FF;
+const int kWin = 1000; // AIPlayer::evaluate's result scores, for the AI
+const int kLimit = PatternEvaluator<GameBoard>::kMaxScore;
+
+// Line weights by stone count, as in the pattern table: 4^(n - 1)
+const int kWeight[4] = { 0, 1, 4, 16 };
+
+void evaluateScalar(const uint16_t* xMasks, const uint16_t* oMasks, size_t count, int8_t* outcomes,
+                    int16_t* scores) {
+    for (size_t i = 0; i < count; i++) {
+        uint16_t x = xMasks[i];
+        uint16_t o = oMasks[i];
+        bool x_wins = false;
+        bool o_wins = false;
+        int raw = 0;
+        for (uint16_t line : kLines) {
+            int own_x = popCount64(x & line);
+            int own_o = popCount64(o & line);
+            x_wins |= own_x == 3;
+            o_wins |= own_o == 3;
+            if (own_o == 0) {
+                raw += kWeight[own_x];
+            }
+            if (own_x == 0) {
+                raw -= kWeight[own_o];
+            }
+        }
+        if (x_wins) {
+            outcomes[i] = 1;
+            scores[i] = -kWin;
+        } else if (o_wins) {
+            outcomes[i] = -1;
+            scores[i] = kWin;
+        } else if ((x | o) == kFull) {
+            outcomes[i] = 2;
+            scores[i] = 0;
+        } else {
+            outcomes[i] = 0;
+            scores[i] = int16_t(std::max(-kLimit, std::min(kLimit, -raw)));
+        }
+    }
+}
+
+#if BATCHEVAL_X86
+
+// Per-lane popcount of 16-bit words
+__attribute__((target("sse4.1"))) inline __m128i popCount16x8(__m128i v) {
+    const __m128i table = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low = _mm_set1_epi8(0x0F);
+    __m128i bytes = _mm_add_epi8(_mm_shuffle_epi8(table, _mm_and_si128(v, low)),
+                                 _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), low)));
+    return _mm_add_epi16(_mm_and_si128(bytes, _mm_set1_epi16(0xFF)), _mm_srli_epi16(bytes, 8));
+}
+
+// 8 boards per step, one 16-bit lane each
+__attribute__((target("sse4.1"))) size_t evaluateSSE41(const uint16_t* xMasks, const uint16_t* oMasks,
+                                                       size_t count, int8_t* outcomes, int16_t* scores) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i two = _mm_set1_epi16(2);
+    const __m128i three = _mm_set1_epi16(3);
+    // Weight of n stones for n <= 3, looked up bytewise
+    const __m128i weights = _mm_setr_epi8(0, 1, 4, 16, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(xMasks + i));
+        __m128i o = _mm_loadu_si128(reinterpret_cast<const __m128i*>(oMasks + i));
+        __m128i x_wins = zero;
+        __m128i o_wins = zero;
+        __m128i raw = zero;
+        for (uint16_t line : kLines) {
+            __m128i mask = _mm_set1_epi16(short(line));
+            __m128i own_x = popCount16x8(_mm_and_si128(x, mask));
+            __m128i own_o = popCount16x8(_mm_and_si128(o, mask));
+            x_wins = _mm_or_si128(x_wins, _mm_cmpeq_epi16(own_x, three));
+            o_wins = _mm_or_si128(o_wins, _mm_cmpeq_epi16(own_o, three));
+            // Counts fit in the low byte, so pshufb reads the weight there
+            __m128i weight_x = _mm_shuffle_epi8(weights, own_x);
+            __m128i weight_o = _mm_shuffle_epi8(weights, own_o);
+            raw = _mm_add_epi16(raw, _mm_and_si128(_mm_cmpeq_epi16(own_o, zero), weight_x));
+            raw = _mm_sub_epi16(raw, _mm_and_si128(_mm_cmpeq_epi16(own_x, zero), weight_o));
+        }
+        __m128i full = _mm_cmpeq_epi16(_mm_or_si128(x, o), _mm_set1_epi16(short(kFull)));
+        __m128i score = _mm_max_epi16(_mm_set1_epi16(short(-kLimit)),
+                                      _mm_min_epi16(_mm_set1_epi16(short(kLimit)), _mm_sub_epi16(zero, raw)));
+        __m128i outcome = _mm_blendv_epi8(zero, two, full);
+        score = _mm_blendv_epi8(score, zero, full);
+        outcome = _mm_blendv_epi8(outcome, _mm_set1_epi16(-1), o_wins);
+        score = _mm_blendv_epi8(score, _mm_set1_epi16(short(kWin)), o_wins);
+        outcome = _mm_blendv_epi8(outcome, one, x_wins);
+        score = _mm_blendv_epi8(score, _mm_set1_epi16(short(-kWin)), x_wins);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(scores + i), score);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(outcomes + i), _mm_packs_epi16(outcome, outcome));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) inline __m256i popCount16x16(__m256i v) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(v, low)),
+                                    _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+    return _mm256_add_epi16(_mm256_and_si256(bytes, _mm256_set1_epi16(0xFF)), _mm256_srli_epi16(bytes, 8));
+}
+
+// 16 boards per step
+__attribute__((target("avx2"))) size_t evaluateAVX2(const uint16_t* xMasks, const uint16_t* oMasks, size_t count,
+                                                    int8_t* outcomes, int16_t* scores) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i two = _mm256_set1_epi16(2);
+    const __m256i three = _mm256_set1_epi16(3);
+    const __m256i weights = _mm256_setr_epi8(0, 1, 4, 16, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                             0, 1, 4, 16, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(xMasks + i));
+        __m256i o = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(oMasks + i));
+        __m256i x_wins = zero;
+        __m256i o_wins = zero;
+        __m256i raw = zero;
+        for (uint16_t line : kLines) {
+            __m256i mask = _mm256_set1_epi16(short(line));
+            __m256i own_x = popCount16x16(_mm256_and_si256(x, mask));
+            __m256i own_o = popCount16x16(_mm256_and_si256(o, mask));
+            x_wins = _mm256_or_si256(x_wins, _mm256_cmpeq_epi16(own_x, three));
+            o_wins = _mm256_or_si256(o_wins, _mm256_cmpeq_epi16(own_o, three));
+            __m256i weight_x = _mm256_shuffle_epi8(weights, own_x);
+            __m256i weight_o = _mm256_shuffle_epi8(weights, own_o);
+            raw = _mm256_add_epi16(raw, _mm256_and_si256(_mm256_cmpeq_epi16(own_o, zero), weight_x));
+            raw = _mm256_sub_epi16(raw, _mm256_and_si256(_mm256_cmpeq_epi16(own_x, zero), weight_o));
+        }
+        __m256i full = _mm256_cmpeq_epi16(_mm256_or_si256(x, o), _mm256_set1_epi16(short(kFull)));
+        __m256i score = _mm256_max_epi16(_mm256_set1_epi16(short(-kLimit)),
+                                         _mm256_min_epi16(_mm256_set1_epi16(short(kLimit)), _mm256_sub_epi16(zero, raw)));
+        __m256i outcome = _mm256_blendv_epi8(zero, two, full);
+        score = _mm256_blendv_epi8(score, zero, full);
+        outcome = _mm256_blendv_epi8(outcome, _mm256_set1_epi16(-1), o_wins);
+        score = _mm256_blendv_epi8(score, _mm256_set1_epi16(short(kWin)), o_wins);
+        outcome = _mm256_blendv_epi8(outcome, one, x_wins);
+        score = _mm256_blendv_epi8(score, _mm256_set1_epi16(short(-kWin)), x_wins);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(scores + i), score);
+        // packs works per 128-bit half, so pack the halves against each other
+        __m128i packed = _mm_packs_epi16(_mm256_castsi256_si128(outcome), _mm256_extracti128_si256(outcome, 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outcomes + i), packed);
+    }
+    return i;
+}
+
+#endif // BATCHEVAL_X86
+
+} // namespace
+
+void BatchEvaluator::evaluateRange(const uint16_t* xMasks, const uint16_t* oMasks, size_t count, int8_t* outcomes,
+                                   int16_t* scores) {
+    size_t done = 0;
+#if BATCHEVAL_X86
+    ScanKernel kernel = activeScanKernel();
+    if (kernel == ScanKernel::AVX2) {
+        done = evaluateAVX2(xMasks, oMasks, count, outcomes, scores);
+    } else if (kernel == ScanKernel::SSE41) {
+        done = evaluateSSE41(xMasks, oMasks, count, outcomes, scores);
+    }
+#endif
+    // The scalar kernel, or the tail that does not fill a vector
+    evaluateScalar(xMasks + done, oMasks + done, count - done, outcomes + done, scores + done);
+}
+
+void BatchEvaluator::evaluate(const uint16_t* xMasks, const uint16_t* oMasks, size_t count, int8_t* outcomes,
+                              int16_t* scores) {
+    size_t chunks = std::min(size_t(pool.size()), count / kMinChunk);
+    if (chunks <= 1) {
+        evaluateRange(xMasks, oMasks, count, outcomes, scores);
+        return;
+    }
+    // Contiguous ranges rounded to whole AVX2 steps; idle workers return at once
+    size_t chunk = (count / chunks + 15) / 16 * 16;
+    pool.run([&](int worker) {
+        size_t begin = std::min(count, size_t(worker) * chunk);
+        size_t end = std::min(count, begin + chunk);
+        if (begin < end) {
+            evaluateRange(xMasks + begin, oMasks + begin, end - begin, outcomes + begin, scores + begin);
+        }
+    });
+}
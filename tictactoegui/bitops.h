@@ -0,0 +1,43 @@
+#ifndef BITOPS_H
+#define BITOPS_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Portable population count and lowest-set-bit index for 64-bit masks
+inline int popCount64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return int(__popcnt64(x));
+#else
+    int count = 0;
+    for (; x; x &= x - 1) {
+        count++;
+    }
+    return count;
+#endif
+}
+
+// x must be non-zero
+inline int lowestBit64(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return int(index);
+#else
+    int index = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+#endif // BITOPS_H
@@ -0,0 +1,588 @@
+#ifndef BOARDSEARCH_H
+#define BOARDSEARCH_H
+
+#include "moveordering.h"
+#include "patterneval.h"
+#include "transpositiontable.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Detects boards that can map a position to a canonical symmetric image
+template <class Board, class = void>
+struct HasCanonical : std::false_type {};
+template <class Board>
+struct HasCanonical<Board, std::void_t<decltype(std::declval<const Board&>().canonical(nullptr))>> : std::true_type {};
+
+// Root-to-leaf algorithm used by BoardSearch
+enum class SearchAlgorithm {
+    AlphaBeta, // Minimax form with separate max and min branches
+    PVS,       // Negamax with Principal Variation Search (negascout)
+    MTDF       // Zero-window alpha-beta passes converging on the value
+};
+
+// Budget for one iterative-deepening search; zero means no limit
+struct SearchLimits {
+    int maxDepth = 64;  // plies, counting the root move
+    int startDepth = 1; // first iteration; Lazy SMP helpers start deeper
+    int timeMs = 0;     // wall-clock budget
+    uint64_t nodes = 0; // node budget
+};
+
+// What the last search did
+struct SearchStats {
+    uint64_t nodes = 0;
+    int depth = 0; // last fully completed depth
+    int score = 0; // score of the returned move at that depth
+    uint64_t cutoffs = 0;          // nodes that failed high
+    uint64_t firstMoveCutoffs = 0; // ... on the first move tried
+    uint64_t researches = 0;       // PVS null-window probes searched again
+    uint64_t passes = 0;           // MTD(f) zero-window root searches
+    uint64_t splits = 0;           // YBWC nodes whose siblings became tasks
+    uint64_t steals = 0;           // ... tasks taken from another thread
+    uint64_t aborts = 0;           // ... tasks dropped after a sibling's cutoff
+
+    // Share of cutoffs found by the first move; near 1 means good ordering
+    double firstMoveCutoffRate() const {
+        return cutoffs == 0 ? 0.0 : double(firstMoveCutoffs) / double(cutoffs);
+    }
+};
+
+// Alpha-beta search with a transposition table, generating moves with
+// make/unmake on a single board. Works on any board that offers cells(),
+// isEmpty, play, undo, hash, checkWin and checkWinAfter(cell): GameBoard,
+// every MNKBoard and the runtime-sized GridBoard. Scores are from the maximizing player's point of view, as in
+// AIPlayer::evaluate: +1000 win, -1000 loss, 0 draw or unknown. With a
+// LeafEvaluator (pattern table or NNUE) attached, positions cut off by the
+// depth limit get its heuristic score (at most +-500) instead of 0.
+//
+// Moves are tried in MoveOrdering's order: the transposition-table move,
+// the two killer moves of the ply, then by history score, with the number
+// of winning lines through a cell breaking ties. Boards also need rows(),
+// cols() and k() for that last prior.
+template <class Board>
+class BoardSearch {
+public:
+    static constexpr int kWinScore = 1000;
+    static constexpr int kInfinity = kWinScore + 1; // Bound for negamax windows
+
+    explicit BoardSearch(size_t tableEntries = 1 << 16) : table(tableEntries), maxPlayer(-1) {}
+
+    // Best cell for player to play, searching depth plies below each move;
+    // -1 if the game is already over
+    int bestMove(Board& board, int player, int depth) {
+        setMaxPlayer(player);
+        startSearch(board, SearchLimits());
+        if (board.checkWin() != 0) {
+            return -1;
+        }
+        int best_score = 0;
+        if (algorithm == SearchAlgorithm::MTDF) {
+            return mtdf(board, player, depth, -1, best_score);
+        }
+        return searchRoot(board, player, depth, -1, best_score);
+    }
+
+    // Iterative deepening: searches one ply deeper at a time until a limit
+    // is hit, and returns the best move of the last depth that completed
+    int bestMove(Board& board, int player, const SearchLimits& limits) {
+        setMaxPlayer(player);
+        startSearch(board, limits);
+        if (board.checkWin() != 0) {
+            return -1;
+        }
+        int empty = 0;
+        for (int cell = 0; cell < board.cells(); cell++) {
+            empty += board.isEmpty(cell) ? 1 : 0;
+        }
+        int best_cell = -1;
+        for (int depth = std::max(1, limits.startDepth); depth <= limits.maxDepth; depth++) {
+            // Start each iteration from the previous best move; MTD(f) also
+            // takes the previous value as its first guess
+            int score = stats.score;
+            int cell = algorithm == SearchAlgorithm::MTDF ? mtdf(board, player, depth - 1, best_cell, score)
+                                                            : searchRoot(board, player, depth - 1, best_cell, score);
+            if (stopped) {
+                break;
+            }
+            best_cell = cell;
+            stats.depth = depth;
+            stats.score = score;
+            if (depth >= empty || score == kWinScore || score == -kWinScore) {
+                break; // Searched to the end of the game, or the result is forced
+            }
+        }
+        if (best_cell == -1) {
+            // Not even depth 1 finished: any legal move beats none
+            for (int cell = 0; cell < board.cells() && best_cell == -1; cell++) {
+                best_cell = board.isEmpty(cell) ? cell : -1;
+            }
+        }
+        return best_cell;
+    }
+
+    const SearchStats& lastSearch() const { return stats; }
+
+    // Hooks for drivers that split the root moves themselves (ParallelSearch):
+    // beginSearch resets the budget and stats, scoreMove values one root move
+    // with the window (alpha, +inf), and stoppedEarly tells whether the
+    // budget ran out, in which case the score must be thrown away
+    void beginSearch(const Board& board, int player, const SearchLimits& searchLimits) {
+        setMaxPlayer(player);
+        startSearch(board, searchLimits);
+    }
+
+    int scoreMove(Board& board, int player, int cell, int depth, int alpha) {
+        makeMove(board, cell, player);
+        ply++;
+        int score = searchNode(board, alpha, std::numeric_limits<int>::max(), false, depth, cell);
+        ply--;
+        unmakeMove(board, cell, player);
+        return score;
+    }
+
+    bool stoppedEarly() const { return stopped; }
+
+    // Value of board with is_max telling whether the maximizing player moves
+    int alphaBeta(Board& board, int alpha, int beta, bool is_max, int depth) {
+        prepareOrdering(board);
+        if (evaluator != nullptr) {
+            evaluator->reset(board);
+        }
+        ply = 0;
+        return searchNode(board, alpha, beta, is_max, depth, -1);
+    }
+
+    void setAlgorithm(SearchAlgorithm selected) {
+        if (selected != algorithm) {
+            activeTable().clear(); // PVS stores scores from the mover's side, the others from the maximizer's
+            algorithm = selected;
+        }
+    }
+
+    // Heuristic for unfinished leaves (nullptr: score them 0). Kept in step
+    // with the board through make/unmake; it must outlive the searches.
+    void setEvaluator(LeafEvaluator<Board>* heuristic) {
+        if (heuristic != evaluator) {
+            activeTable().clear(); // Stored scores came from the old leaf values
+            evaluator = heuristic;
+        }
+    }
+
+    // Off: the table move first, then plain board order (for comparisons)
+    void setMoveOrdering(bool enabled) { order.setEnabled(enabled); }
+
+    void setMaxPlayer(int player) {
+        if (player != maxPlayer) {
+            activeTable().clear(); // Stored scores are relative to the old side
+            maxPlayer = player;
+        }
+    }
+
+    void clear() {
+        activeTable().clear();
+        order.clearHistory();
+    }
+
+    // Lazy SMP: probe and store in other instead of table (nullptr: own table).
+    // The table must outlive the search, and is cleared with it.
+    void shareTable(TranspositionTable* other) { shared = other; }
+
+    // Lets another thread stop the search; polled with the budget
+    void setStopFlag(const std::atomic<bool>* flag) { stopFlag = flag; }
+
+    // Root moves are tried from this cell on (wrapping), after the previous
+    // best; gives Lazy SMP helpers different trees to search
+    void setRootOffset(int offset) { rootOffset = offset; }
+
+    TranspositionTable table;
+
+    // Keys side to move into the hash; boards with symmetry share entries.
+    // Public, with the cell mappings below, so YBWCSearch can share a table
+    static uint64_t key(const Board& board, bool is_max, int& transform) {
+        const uint64_t kMaxSideKey = 0x9D39247E33776D41ull;
+        transform = 0;
+        uint64_t hash;
+        if constexpr (HasCanonical<Board>::value) {
+            hash = board.canonical(&transform).hash();
+        } else {
+            hash = board.hash();
+        }
+        return hash ^ (is_max ? kMaxSideKey : 0);
+    }
+
+    static int toKeyCell(int cell, int transform) {
+        if constexpr (HasCanonical<Board>::value) {
+            return cell < 0 ? cell : Board::transformCell(cell, transform);
+        }
+        return cell;
+    }
+
+    static int fromKeyCell(int cell, int transform) {
+        if constexpr (HasCanonical<Board>::value) {
+            return cell < 0 ? cell : Board::inverseTransformCell(cell, transform);
+        }
+        return cell;
+    }
+
+private:
+    void startSearch(const Board& board, const SearchLimits& searchLimits) {
+        limits = searchLimits;
+        stats = SearchStats();
+        stopped = false;
+        ply = 0;
+        prepareOrdering(board);
+        if (evaluator != nullptr) {
+            evaluator->reset(board);
+        }
+        order.age();
+        start = std::chrono::steady_clock::now();
+    }
+
+    // Sizes the per-ply move lists and the ordering tables for board
+    void prepareOrdering(const Board& board) {
+        order.prepare(board);
+        size_t plies = size_t(board.cells() + 2);
+        if (moveLists.size() != plies || moveLists[0].size() != size_t(board.cells())) {
+            moveLists.assign(plies, std::vector<uint64_t>(size_t(board.cells())));
+        }
+    }
+
+    void recordCutoff(int cell, int side, int depth, int move_index) {
+        stats.cutoffs++;
+        if (move_index == 0) {
+            stats.firstMoveCutoffs++;
+        }
+        order.recordCutoff(cell, side, ply, depth);
+    }
+
+    // Polled every 256 nodes, so the search stops well within a millisecond
+    bool outOfBudget() const {
+        if (stopFlag != nullptr && stopFlag->load(std::memory_order_relaxed)) {
+            return true;
+        }
+        if (limits.nodes != 0 && stats.nodes >= limits.nodes) {
+            return true;
+        }
+        if (limits.timeMs != 0) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            return elapsed >= std::chrono::milliseconds(limits.timeMs);
+        }
+        return false;
+    }
+
+    // Root move loop; first_cell, if any, is searched before the others
+    int searchRoot(Board& board, int player, int depth, int first_cell, int& best_score) {
+        best_score = std::numeric_limits<int>::min();
+        int best_cell = -1;
+        int cells = board.cells();
+        for (int i = -1; i < cells; i++) {
+            int cell = i < 0 ? first_cell : (i + rootOffset) % cells;
+            if (cell < 0 || (i >= 0 && cell == first_cell) || !board.isEmpty(cell)) {
+                continue;
+            }
+            makeMove(board, cell, player);
+            // Later moves only need to prove they match the best so far; the
+            // window keeps ties exact so they can go to the lowest cell
+            int alpha = best_cell == -1 ? std::numeric_limits<int>::min() : best_score - 1;
+            ply++;
+            int score = searchNode(board, alpha, std::numeric_limits<int>::max(), false, depth, cell);
+            ply--;
+            unmakeMove(board, cell, player);
+            if (stopped) {
+                break;
+            }
+            if (best_cell == -1 || score > best_score || (score == best_score && cell < best_cell)) {
+                best_score = score;
+                best_cell = cell;
+            }
+        }
+        return best_cell;
+    }
+
+    // MTD(f): zero-window searches around a guess until the upper and lower
+    // bounds meet. score holds the first guess and returns the value.
+    int mtdf(Board& board, int player, int depth, int first_cell, int& score) {
+        int lower = -kInfinity;
+        int upper = kInfinity;
+        int guess = std::max(-kWinScore, std::min(kWinScore, score));
+        int best_cell = -1;
+        while (lower < upper) {
+            int beta = guess == lower ? guess + 1 : guess;
+            int cell = -1;
+            stats.passes++;
+            guess = zeroWindowRoot(board, player, depth, first_cell, beta, cell);
+            if (stopped) {
+                break;
+            }
+            if (guess < beta) {
+                upper = guess;
+                if (best_cell == -1) {
+                    best_cell = cell; // Best of the failed-low moves, if nothing beats it
+                }
+            } else {
+                lower = guess;
+                best_cell = cell;
+                first_cell = cell;
+            }
+        }
+        score = guess;
+        return best_cell;
+    }
+
+    // One MTD(f) pass over the root moves with the window (beta - 1, beta);
+    // stops at the first move that reaches beta
+    int zeroWindowRoot(Board& board, int player, int depth, int first_cell, int beta, int& best_cell) {
+        int best_score = -kInfinity;
+        for (int i = -1; i < board.cells(); i++) {
+            int cell = i < 0 ? first_cell : i;
+            if (cell < 0 || (i >= 0 && cell == first_cell) || !board.isEmpty(cell)) {
+                continue;
+            }
+            makeMove(board, cell, player);
+            ply++;
+            int score = search(board, beta - 1, beta, false, depth, cell);
+            ply--;
+            unmakeMove(board, cell, player);
+            if (stopped) {
+                break;
+            }
+            if (score > best_score) {
+                best_score = score;
+                best_cell = cell;
+            }
+            if (score >= beta) {
+                break;
+            }
+        }
+        return best_score;
+    }
+
+    int evaluate(int result) const {
+        if (result == maxPlayer) {
+            return kWinScore;
+        } else if (result == -maxPlayer) {
+            return -kWinScore;
+        }
+        if (result == 0 && evaluator != nullptr) {
+            return evaluator->score(maxPlayer); // Not finished within the depth limit
+        }
+        return 0; // Draw, or not finished within the depth limit
+    }
+
+    void makeMove(Board& board, int cell, int player) {
+        board.play(cell, player);
+        if (evaluator != nullptr) {
+            evaluator->place(cell, player);
+        }
+    }
+
+    void unmakeMove(Board& board, int cell, int player) {
+        board.undo(cell);
+        if (evaluator != nullptr) {
+            evaluator->remove(cell, player);
+        }
+    }
+
+    // Counts a node and polls the budget; true once the search must unwind
+    bool countNode() {
+        if ((++stats.nodes & 255) == 0 && !stopped && outOfBudget()) {
+            stopped = true;
+        }
+        return stopped;
+    }
+
+    // Narrows [alpha, beta] from a stored entry; true if the entry alone
+    // settles the node, with its score in score
+    bool probeTable(uint64_t hash, int transform, int depth, int& alpha, int& beta, int& tt_move, int& score) {
+        TranspositionTable::Entry entry;
+        if (!activeTable().probe(hash, entry)) {
+            return false;
+        }
+        tt_move = fromKeyCell(entry.bestMove, transform);
+        if (entry.depth < depth) {
+            return false;
+        }
+        if (entry.bound == TranspositionTable::Exact) {
+            score = entry.score;
+            return true;
+        } else if (entry.bound == TranspositionTable::Lower) {
+            alpha = std::max(alpha, entry.score);
+        } else if (entry.bound == TranspositionTable::Upper) {
+            beta = std::min(beta, entry.score);
+        }
+        score = entry.score;
+        return alpha >= beta;
+    }
+
+    void storeTable(uint64_t hash, int transform, int depth, int alpha_orig, int beta_orig, int score, int best_move) {
+        TranspositionTable::Bound bound = TranspositionTable::Exact;
+        if (score <= alpha_orig) {
+            bound = TranspositionTable::Upper;
+        } else if (score >= beta_orig) {
+            bound = TranspositionTable::Lower;
+        }
+        activeTable().store(hash, score, bound, depth, toKeyCell(best_move, transform));
+    }
+
+    // Child search in the selected algorithm, scored for the maximizing player
+    int searchNode(Board& board, int alpha, int beta, bool is_max, int depth, int last_cell) {
+        if (algorithm != SearchAlgorithm::PVS) {
+            return search(board, alpha, beta, is_max, depth, last_cell);
+        }
+        // Negamax works from the mover's side; clamp so negation cannot overflow
+        alpha = std::max(alpha, -kInfinity);
+        beta = std::min(beta, kInfinity);
+        return is_max ? pvs(board, alpha, beta, true, depth, last_cell)
+                      : -pvs(board, -beta, -alpha, false, depth, last_cell);
+    }
+
+    // last_cell is the stone just played, so only its lines need checking
+    int search(Board& board, int alpha, int beta, bool is_max, int depth, int last_cell) {
+        if (countNode()) {
+            return 0; // Unwind; the caller throws this iteration away
+        }
+        int result = last_cell >= 0 ? board.checkWinAfter(last_cell) : board.checkWin();
+        if (result != 0 || depth == 0) {
+            return evaluate(result);
+        }
+
+        int transform = 0;
+        uint64_t hash = key(board, is_max, transform);
+        int tt_move = -1;
+        int tt_score = 0;
+        if (probeTable(hash, transform, depth, alpha, beta, tt_move, tt_score)) {
+            return tt_score;
+        }
+
+        int alpha_orig = alpha;
+        int beta_orig = beta;
+        int player = is_max ? maxPlayer : -maxPlayer;
+        int best_score = is_max ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+        int best_move = -1;
+        int side = player > 0 ? 0 : 1;
+        std::vector<uint64_t>& moves = moveLists[ply];
+        int count = order.generate(board, tt_move, side, ply, moves);
+        for (int i = 0; i < count; i++) {
+            int cell = MoveOrdering::pick(moves, i, count);
+            makeMove(board, cell, player);
+            ply++;
+            int score = search(board, alpha, beta, !is_max, depth - 1, cell);
+            ply--;
+            unmakeMove(board, cell, player);
+            if (is_max) {
+                if (score > best_score) {
+                    best_score = score;
+                    best_move = cell;
+                }
+                alpha = std::max(alpha, score);
+            } else {
+                if (score < best_score) {
+                    best_score = score;
+                    best_move = cell;
+                }
+                beta = std::min(beta, score);
+            }
+            if (alpha >= beta) {
+                if (!stopped) {
+                    recordCutoff(cell, side, depth, i);
+                }
+                break;
+            }
+        }
+        if (stopped) {
+            return 0; // Incomplete results must not reach the table
+        }
+        storeTable(hash, transform, depth, alpha_orig, beta_orig, best_score, best_move);
+        return best_score;
+    }
+
+    // Negamax with Principal Variation Search: the first move gets the full
+    // window, the rest a null window that is widened only when it fails
+    // high. Scores are from the side to move's point of view, and so are
+    // the table entries (the table is cleared when switching algorithms).
+    int pvs(Board& board, int alpha, int beta, bool is_max, int depth, int last_cell) {
+        if (countNode()) {
+            return 0;
+        }
+        int result = last_cell >= 0 ? board.checkWinAfter(last_cell) : board.checkWin();
+        if (result != 0 || depth == 0) {
+            return is_max ? evaluate(result) : -evaluate(result);
+        }
+
+        int transform = 0;
+        uint64_t hash = key(board, is_max, transform);
+        int tt_move = -1;
+        int tt_score = 0;
+        if (probeTable(hash, transform, depth, alpha, beta, tt_move, tt_score)) {
+            return tt_score;
+        }
+
+        int alpha_orig = alpha;
+        int player = is_max ? maxPlayer : -maxPlayer;
+        int best_score = -kInfinity;
+        int best_move = -1;
+        int side = player > 0 ? 0 : 1;
+        std::vector<uint64_t>& moves = moveLists[ply];
+        int count = order.generate(board, tt_move, side, ply, moves);
+        for (int i = 0; i < count; i++) {
+            int cell = MoveOrdering::pick(moves, i, count);
+            makeMove(board, cell, player);
+            ply++;
+            int score;
+            if (i == 0) {
+                score = -pvs(board, -beta, -alpha, !is_max, depth - 1, cell);
+            } else {
+                score = -pvs(board, -alpha - 1, -alpha, !is_max, depth - 1, cell);
+                if (score > alpha && score < beta) {
+                    stats.researches++;
+                    score = -pvs(board, -beta, -alpha, !is_max, depth - 1, cell);
+                }
+            }
+            ply--;
+            unmakeMove(board, cell, player);
+            if (score > best_score) {
+                best_score = score;
+                best_move = cell;
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) {
+                if (!stopped) {
+                    recordCutoff(cell, side, depth, i);
+                }
+                break;
+            }
+        }
+        if (stopped) {
+            return 0;
+        }
+        storeTable(hash, transform, depth, alpha_orig, beta, best_score, best_move);
+        return best_score;
+    }
+
+    TranspositionTable& activeTable() { return shared != nullptr ? *shared : table; }
+    const TranspositionTable& activeTable() const { return shared != nullptr ? *shared : table; }
+
+    int maxPlayer;
+    TranspositionTable* shared = nullptr;
+    const std::atomic<bool>* stopFlag = nullptr;
+    LeafEvaluator<Board>* evaluator = nullptr;
+    int rootOffset = 0;
+    SearchAlgorithm algorithm = SearchAlgorithm::AlphaBeta;
+    SearchLimits limits;
+    SearchStats stats;
+    bool stopped = false;
+    std::chrono::steady_clock::time_point start;
+
+    // Move ordering state
+    MoveOrdering order;
+    int ply = 0; // distance from the root of the current search
+    std::vector<std::vector<uint64_t>> moveLists; // scratch move list per ply
+};
+
+#endif // BOARDSEARCH_H
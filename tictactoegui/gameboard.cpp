@@ -1,12 +1,97 @@
 #include "gameboard.h"
+#include <array>
 #include <iostream>
 
-GameBoard::GameBoard() {
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            board[i][j] = 0;
+namespace {
+
+const uint16_t kFullMask = 0x1FF;
+
+// The eight winning lines as 9-bit masks: rows, columns, then both diagonals
+const uint16_t kLineMasks[8] = {
+    0x007, 0x038, 0x1C0,
+    0x049, 0x092, 0x124,
+    0x111, 0x054
+};
+
+// Where each cell lands under each transform, as (row, col) -> row * 3 + col
+const int kSymmetryCells[8][9] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8 }, // identity
+    { 2, 5, 8, 1, 4, 7, 0, 3, 6 }, // rotate 90: (r, c) -> (c, 2 - r)
+    { 8, 7, 6, 5, 4, 3, 2, 1, 0 }, // rotate 180
+    { 6, 3, 0, 7, 4, 1, 8, 5, 2 }, // rotate 270: (r, c) -> (2 - c, r)
+    { 2, 1, 0, 5, 4, 3, 8, 7, 6 }, // mirror columns
+    { 6, 7, 8, 3, 4, 5, 0, 1, 2 }, // mirror rows
+    { 0, 3, 6, 1, 4, 7, 2, 5, 8 }, // transpose
+    { 8, 5, 2, 7, 4, 1, 6, 3, 0 }  // anti-transpose
+};
+const int kInverseTransform[8] = { 0, 3, 2, 1, 4, 5, 6, 7 };
+
+// The lines through each cell, as indices into kLineMasks
+const int kCellLines[9][5] = {
+    { 0, 3, 6, -1 }, { 0, 4, -1 }, { 0, 5, 7, -1 },
+    { 1, 3, -1 }, { 1, 4, 6, 7, -1 }, { 1, 5, -1 },
+    { 2, 3, 7, -1 }, { 2, 4, -1 }, { 2, 5, 6, -1 }
+};
+
+// Every 9-bit mask pushed through every transform, built at compile time
+struct SymmetryTables {
+    std::array<std::array<uint16_t, 512>, 8> masks{};
+    std::array<uint64_t, 512> xHash{}; // Zobrist hash of a player 1 mask
+    std::array<uint64_t, 512> oHash{}; // Zobrist hash of a player 2 mask
+};
+
+constexpr SymmetryTables makeSymmetryTables() {
+    SymmetryTables tables;
+    for (int mask = 0; mask < 512; ++mask) {
+        for (int t = 0; t < 8; ++t) {
+            uint16_t image = 0;
+            for (int cell = 0; cell < 9; ++cell) {
+                if (mask & (1 << cell)) {
+                    image |= uint16_t(1u << kSymmetryCells[t][cell]);
+                }
+            }
+            tables.masks[t][mask] = image;
+        }
+        for (int cell = 0; cell < 9; ++cell) {
+            if (mask & (1 << cell)) {
+                tables.xHash[mask] ^= ZobristKeys<9>::keys[cell * 2];
+                tables.oHash[mask] ^= ZobristKeys<9>::keys[cell * 2 + 1];
+            }
         }
     }
+    return tables;
+}
+
+constexpr SymmetryTables kSymmetry = makeSymmetryTables();
+
+// Base-3 value of a mask with every set cell counted as digit 1
+constexpr std::array<uint16_t, 512> makeBase3() {
+    std::array<uint16_t, 512> base3{};
+    for (int mask = 0; mask < 512; ++mask) {
+        int pow3 = 1;
+        for (int cell = 0; cell < 9; ++cell, pow3 *= 3) {
+            if (mask & (1 << cell)) {
+                base3[mask] = uint16_t(base3[mask] + pow3);
+            }
+        }
+    }
+    return base3;
+}
+
+constexpr std::array<uint16_t, 512> kBase3 = makeBase3();
+
+bool hasLine(uint16_t mask) {
+    for (uint16_t line : kLineMasks) {
+        if ((mask & line) == line) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+GameBoard::GameBoard() : xMask(0), oMask(0), zobrist(0) {
 }
 
 void GameBoard::display() const {
@@ -15,9 +100,10 @@ void GameBoard::display() const {
     for (int i = 0; i < 3; ++i) {
         std::cout << i + 1 << "|";
         for (int j = 0; j < 3; ++j) {
-            if (board[i][j] == 1) {
+            int value = getValue(i, j);
+            if (value == 1) {
                 std::cout << "X ";
-            } else if (board[i][j] == -1) {
+            } else if (value == -1) {
                 std::cout << "O ";
             } else {
                 std::cout << "- ";
@@ -29,43 +115,95 @@ void GameBoard::display() const {
 }
 
 int GameBoard::checkWin() const {
-    // Check rows
-    for (int i = 0; i < 3; ++i) {
-        if (board[i][0] + board[i][1] + board[i][2] == 3) {
-            return 1; // Player 1 wins
-        } else if (board[i][0] + board[i][1] + board[i][2] == -3) {
-            return -1; // Player 2 wins
-        }
-    }
-    // Check columns
-    for (int j = 0; j < 3; ++j) {
-        if (board[0][j] + board[1][j] + board[2][j] == 3) {
-            return 1; // Player 1 wins
-        } else if (board[0][j] + board[1][j] + board[2][j] == -3) {
-            return -1; // Player 2 wins
-        }
-    }
-    // Check diagonals
-    if (board[0][0] + board[1][1] + board[2][2] == 3 || board[0][2] + board[1][1] + board[2][0] == 3) {
+    if (hasLine(xMask)) {
         return 1; // Player 1 wins
-    } else if (board[0][0] + board[1][1] + board[2][2] == -3 || board[0][2] + board[1][1] + board[2][0] == -3) {
+    }
+    if (hasLine(oMask)) {
         return -1; // Player 2 wins
     }
-    // Check for draw
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            if (board[i][j] == 0) {
-                return 0; // Game is not over yet
-            }
+    // Every cell taken and no line: the game is a draw
+    if ((xMask | oMask) == kFullMask) {
+        return 2;
+    }
+    return 0; // Game is not over yet
+}
+
+int GameBoard::checkWinAfter(int cell) const {
+    int player = (xMask >> cell) & 1 ? 1 : (oMask >> cell) & 1 ? -1 : 0;
+    uint16_t own = player > 0 ? xMask : oMask;
+    for (const int* line = kCellLines[cell]; player != 0 && *line >= 0; ++line) {
+        if ((own & kLineMasks[*line]) == kLineMasks[*line]) {
+            return player;
         }
     }
-    return 2; // Game is a draw
+    return (xMask | oMask) == kFullMask ? 2 : 0;
 }
 
 int GameBoard::getValue(int row, int col) const {
-    return board[row][col];
+    if (row < 0 || row >= 3 || col < 0 || col >= 3) {
+        return 0; // Out-of-bounds cells read as empty
+    }
+    uint16_t bit = uint16_t(1u << (row * 3 + col));
+    if (xMask & bit) {
+        return 1;
+    }
+    if (oMask & bit) {
+        return -1;
+    }
+    return 0;
 }
 
 void GameBoard::setValue(int row, int col, int value) {
-    board[row][col] = value;
+    if (row < 0 || row >= 3 || col < 0 || col >= 3) {
+        return;
+    }
+    int cell = row * 3 + col;
+    uint16_t bit = uint16_t(1u << cell);
+    // XOR out whatever occupied the cell, then XOR in the new owner
+    if (xMask & bit) {
+        zobrist ^= ZobristKeys<9>::key(cell, 1);
+    } else if (oMask & bit) {
+        zobrist ^= ZobristKeys<9>::key(cell, -1);
+    }
+    xMask &= uint16_t(~bit);
+    oMask &= uint16_t(~bit);
+    if (value > 0) {
+        xMask |= bit;
+        zobrist ^= ZobristKeys<9>::key(cell, 1);
+    } else if (value < 0) {
+        oMask |= bit;
+        zobrist ^= ZobristKeys<9>::key(cell, -1);
+    }
+}
+
+int GameBoard::encode() const {
+    return kBase3[xMask] + 2 * kBase3[oMask];
+}
+
+GameBoard GameBoard::canonical(int* transform) const {
+    int best = 0;
+    uint32_t bestCode = uint32_t(xMask) << 9 | oMask;
+    for (int t = 1; t < 8; ++t) {
+        uint32_t code = uint32_t(kSymmetry.masks[t][xMask]) << 9 | kSymmetry.masks[t][oMask];
+        if (code < bestCode) {
+            bestCode = code;
+            best = t;
+        }
+    }
+    GameBoard image;
+    image.xMask = uint16_t(bestCode >> 9);
+    image.oMask = uint16_t(bestCode & 0x1FF);
+    image.zobrist = kSymmetry.xHash[image.xMask] ^ kSymmetry.oHash[image.oMask];
+    if (transform) {
+        *transform = best;
+    }
+    return image;
+}
+
+int GameBoard::transformCell(int cell, int transform) {
+    return kSymmetryCells[transform][cell];
+}
+
+int GameBoard::inverseTransformCell(int cell, int transform) {
+    return kSymmetryCells[kInverseTransform[transform]][cell];
 }
@@ -1,17 +1,62 @@
 #ifndef GAMEBOARD_H
 #define GAMEBOARD_H
 
+#include "zobrist.h"
+#include <cstdint>
+
 class GameBoard {
 public:
+    static const int kCells = 9;
+    static int cells() { return kCells; }
+    static int rows() { return 3; }
+    static int cols() { return 3; }
+    static int k() { return 3; } // stones in a row needed to win
+
     GameBoard();
 
     void display() const;
     int checkWin() const;
+    int checkWinAfter(int cell) const; // checkWin() when cell holds the last stone played
     int getValue(int row, int col) const;
     void setValue(int row, int col, int value);
 
+    // Occupancy mask of a side: bit (row * 3 + col) is set for each cell it owns
+    uint16_t mask(int player) const { return player > 0 ? xMask : oMask; }
+
+    // Zobrist hash of the position, kept up to date by setValue
+    uint64_t hash() const { return zobrist; }
+
+    // Make/unmake for the search: cell is row * 3 + col and must be empty for play
+    bool isEmpty(int cell) const { return !((xMask | oMask) & (1u << cell)); }
+    void play(int cell, int player) {
+        if (player > 0) {
+            xMask |= uint16_t(1u << cell);
+        } else {
+            oMask |= uint16_t(1u << cell);
+        }
+        zobrist ^= ZobristKeys<9>::key(cell, player);
+    }
+    void undo(int cell) {
+        zobrist ^= ZobristKeys<9>::key(cell, (xMask >> cell) & 1 ? 1 : -1);
+        xMask &= uint16_t(~(1u << cell));
+        oMask &= uint16_t(~(1u << cell));
+    }
+
+    // Base-3 index of the position: digit cell is 0 empty, 1 player 1, 2 player 2
+    int encode() const;
+
+    // Symmetries (D4): transforms 0-7 are identity, the three rotations, then
+    // the four reflections. canonical() returns the smallest symmetric image of
+    // the board and the transform that produced it; a move on the canonical
+    // board maps back with inverseTransformCell(move, transform).
+    GameBoard canonical(int* transform = nullptr) const;
+    static int transformCell(int cell, int transform);
+    static int inverseTransformCell(int cell, int transform);
+
 private:
-    int board[3][3];
+    uint16_t xMask; // Cells owned by player 1 (value 1)
+    uint16_t oMask; // Cells owned by player 2 / AI (value -1)
+    uint64_t zobrist;
 };
 
 #endif // GAMEBOARD_H
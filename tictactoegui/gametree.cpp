@@ -0,0 +1,75 @@
+#include "gametree.h"
+
+GameTree::GameTree() : count(0) {
+}
+
+uint32_t GameTree::build(const GameBoard& board, int player) {
+    reset();
+    uint32_t root = allocate(1);
+    Node& node = this->node(root);
+    node.board = board;
+    node.moveRow = -1;
+    node.moveCol = -1;
+    expand(root, player);
+    return root;
+}
+
+uint32_t GameTree::bestChild(uint32_t index, bool is_max) const {
+    const Node& parent = node(index);
+    uint32_t best = parent.firstChild;
+    for (uint32_t i = parent.firstChild + 1; i < parent.firstChild + parent.childCount; i++) {
+        int score = node(i).score;
+        if (is_max ? score > node(best).score : score < node(best).score) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+uint32_t GameTree::allocate(uint32_t n) {
+    while (count + n > chunks.size() * kChunkSize) {
+        chunks.emplace_back(new Node[kChunkSize]);
+    }
+    uint32_t first = uint32_t(count);
+    count += n;
+    return first;
+}
+
+void GameTree::expand(uint32_t index, int player) {
+    // Chunks never move once allocated, so this reference stays valid
+    Node& parent = node(index);
+    parent.childCount = 0;
+
+    int winner = parent.board.checkWin();
+    if (winner != 0) {
+        parent.score = winner == 1 ? -1000 : winner == -1 ? 1000 : 0;
+        return;
+    }
+
+    // Lay out all children of this node contiguously before descending
+    uint16_t moves = 0;
+    for (int cell = 0; cell < 9; cell++) {
+        if (parent.board.isEmpty(cell)) {
+            moves++;
+        }
+    }
+    parent.firstChild = allocate(moves);
+    parent.childCount = moves;
+    uint32_t next = parent.firstChild;
+    for (int cell = 0; cell < 9; cell++) {
+        if (!parent.board.isEmpty(cell)) {
+            continue;
+        }
+        Node& child = node(next++);
+        child.board = parent.board;
+        child.board.play(cell, player);
+        child.moveRow = int8_t(cell / 3);
+        child.moveCol = int8_t(cell % 3);
+    }
+
+    bool is_max = player == -1; // AI is player -1 and maximizes
+    for (uint32_t i = parent.firstChild; i < parent.firstChild + moves; i++) {
+        expand(i, -player);
+    }
+    parent.score = node(bestChild(index, is_max)).score;
+}
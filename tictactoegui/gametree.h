@@ -0,0 +1,53 @@
+#ifndef GAMETREE_H
+#define GAMETREE_H
+
+#include "gameboard.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Full game tree for analysis and export, stored in an arena of fixed-size
+// chunks. A node's children sit next to each other and are addressed as an
+// index range, so the tree holds no per-node pointers or vectors.
+class GameTree {
+public:
+    struct Node {
+        GameBoard board;
+        uint32_t firstChild; // index of the first child, valid if childCount > 0
+        uint16_t childCount;
+        int8_t moveRow;      // move that led here, -1 for the root
+        int8_t moveCol;
+        int score;           // minimax value from the AI's point of view
+    };
+
+    GameTree();
+
+    // Expand every position reachable from board with player to move, then
+    // score each node with evaluate-style values (AI = -1 wins at +1000).
+    // Returns the index of the root, which is always 0.
+    uint32_t build(const GameBoard& board, int player);
+
+    // Drop all nodes in O(1); chunks are kept for the next build
+    void reset() { count = 0; }
+
+    size_t size() const { return count; }
+    Node& node(uint32_t index) { return chunks[index >> kChunkBits][index & kChunkMask]; }
+    const Node& node(uint32_t index) const { return chunks[index >> kChunkBits][index & kChunkMask]; }
+
+    // Index of the best child of index for the side to move there
+    uint32_t bestChild(uint32_t index, bool is_max) const;
+
+private:
+    static const int kChunkBits = 14;
+    static const uint32_t kChunkSize = 1u << kChunkBits;
+    static const uint32_t kChunkMask = kChunkSize - 1;
+
+    uint32_t allocate(uint32_t n); // bump-allocate n contiguous nodes
+    void expand(uint32_t index, int player);
+
+    std::vector<std::unique_ptr<Node[]>> chunks;
+    uint32_t count;
+};
+
+#endif // GAMETREE_H
@@ -0,0 +1,127 @@
+#include "gridboard.h"
+#include "zobrist.h"
+#include <iostream>
+
+GridBoard::GridBoard(int rows, int cols, int k)
+    : rowCount(rows), colCount(cols), winLength(k), stoneCount(0), winner(0), zobrist(0),
+      board(size_t(rows * cols), 0), neighbour(size_t(rows * cols) * 8, -1), keys(size_t(rows * cols) * 2) {
+    const int directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+    for (int cell = 0; cell < rows * cols; ++cell) {
+        int r = cell / cols;
+        int c = cell % cols;
+        for (int dir = 0; dir < 4; ++dir) {
+            for (int side = 0; side < 2; ++side) {
+                int sign = side == 0 ? 1 : -1;
+                int nr = r + sign * directions[dir][0];
+                int nc = c + sign * directions[dir][1];
+                if (nr >= 0 && nr < rows && nc >= 0 && nc < cols) {
+                    neighbour[(cell * 4 + dir) * 2 + side] = nr * cols + nc;
+                }
+            }
+        }
+        keys[cell * 2] = zobristKey(cell, 1);
+        keys[cell * 2 + 1] = zobristKey(cell, -1);
+    }
+}
+
+void GridBoard::display() const {
+    for (int i = 0; i < rowCount; ++i) {
+        for (int j = 0; j < colCount; ++j) {
+            int value = getValue(i, j);
+            std::cout << (value == 1 ? "X " : value == -1 ? "O " : "- ");
+        }
+        std::cout << std::endl;
+    }
+}
+
+int GridBoard::checkWin() const {
+    if (winner != 0) {
+        return winner;
+    }
+    return stoneCount == cells() ? 2 : 0;
+}
+
+int GridBoard::checkWinAfter(int row, int col) const {
+    if (row < 0 || row >= rowCount || col < 0 || col >= colCount) {
+        return checkWin();
+    }
+    return checkWinAfter(row * colCount + col);
+}
+
+int GridBoard::checkWinAfter(int cell) const {
+    int player = board[cell];
+    if (player != 0) {
+        for (int dir = 0; dir < 4; ++dir) {
+            if (runLength(cell, dir, player) >= winLength) {
+                return player;
+            }
+        }
+    }
+    return stoneCount == cells() ? 2 : 0;
+}
+
+int GridBoard::getValue(int row, int col) const {
+    if (row < 0 || row >= rowCount || col < 0 || col >= colCount) {
+        return 0;
+    }
+    return board[row * colCount + col];
+}
+
+void GridBoard::setValue(int row, int col, int value) {
+    if (row < 0 || row >= rowCount || col < 0 || col >= colCount) {
+        return;
+    }
+    int cell = row * colCount + col;
+    int previous = board[cell];
+    if (previous != 0) {
+        board[cell] = 0;
+        zobrist ^= keys[cell * 2 + (previous > 0 ? 0 : 1)];
+        stoneCount--;
+    }
+    if (value != 0) {
+        play(cell, value > 0 ? 1 : -1);
+    }
+    if (previous != 0) {
+        recomputeWinner(); // A removed stone may have broken the winning line
+    }
+}
+
+void GridBoard::play(int cell, int player) {
+    board[cell] = int8_t(player);
+    zobrist ^= keys[cell * 2 + (player > 0 ? 0 : 1)];
+    stoneCount++;
+    if (winner == 0 && checkWinAfter(cell) == player) {
+        winner = player;
+    }
+}
+
+void GridBoard::undo(int cell) {
+    int player = board[cell];
+    board[cell] = 0;
+    zobrist ^= keys[cell * 2 + (player > 0 ? 0 : 1)];
+    stoneCount--;
+    // Play stops at the first win, so the last stone played made any win
+    winner = 0;
+}
+
+int GridBoard::runLength(int cell, int dir, int player) const {
+    int length = 1;
+    for (int side = 0; side < 2; ++side) {
+        int next = neighbour[(cell * 4 + dir) * 2 + side];
+        for (int step = 1; step < winLength && next >= 0 && board[next] == player; ++step) {
+            length++;
+            next = neighbour[(next * 4 + dir) * 2 + side];
+        }
+    }
+    return length;
+}
+
+void GridBoard::recomputeWinner() {
+    winner = 0;
+    for (int cell = 0; cell < cells() && winner == 0; ++cell) {
+        int result = checkWinAfter(cell);
+        if (result == 1 || result == -1) {
+            winner = result;
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef GRIDBOARD_H
+#define GRIDBOARD_H
+
+#include <cstdint>
+#include <vector>
+
+// m,n,k board whose size is chosen at runtime, e.g. 19x19 five in a row.
+// Winning is detected from the last stone only: precomputed neighbour
+// tables walk at most K - 1 cells each way in four directions, so a win
+// check costs the same on any board size. checkWin() returns the cached
+// result kept up to date by setValue, play and undo.
+class GridBoard {
+public:
+    GridBoard(int rows, int cols, int k);
+
+    void display() const;
+    int checkWin() const;                      // 1, -1, 2 for a draw, 0 if not over
+    int checkWinAfter(int row, int col) const; // result if (row, col) was the last stone
+    int checkWinAfter(int cell) const;
+    int getValue(int row, int col) const;
+    void setValue(int row, int col, int value);
+
+    // Make/unmake for the search; undo only the stone played last
+    bool isEmpty(int cell) const { return board[cell] == 0; }
+    void play(int cell, int player);
+    void undo(int cell);
+
+    int rows() const { return rowCount; }
+    int cols() const { return colCount; }
+    int k() const { return winLength; }
+    int cells() const { return rowCount * colCount; }
+    int stones() const { return stoneCount; }
+    uint64_t hash() const { return zobrist; }
+
+private:
+    // Length of the run of player's stones through cell along direction dir
+    int runLength(int cell, int dir, int player) const;
+    void recomputeWinner();
+
+    int rowCount;
+    int colCount;
+    int winLength;
+    int stoneCount;
+    int winner; // 1 or -1 once someone has K in a row
+    uint64_t zobrist;
+    std::vector<int8_t> board;
+    // neighbour[(cell * 4 + dir) * 2 + side]: next cell along dir (side 0
+    // forwards, 1 backwards) or -1 off the board
+    std::vector<int> neighbour;
+    std::vector<uint64_t> keys;
+};
+
+#endif // GRIDBOARD_H
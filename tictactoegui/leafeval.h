@@ -0,0 +1,24 @@
+#ifndef LEAFEVAL_H
+#define LEAFEVAL_H
+
+// Incremental heuristic a search attaches for its depth-limited leaves:
+// reset at the root, then kept in step with every make/unmake. Both the
+// pattern table and the NNUE network implement it, so BoardSearch can take
+// either one.
+template <class Board>
+class LeafEvaluator {
+public:
+    // Stays clear of the +-1000 win score, so a heuristic never looks like a result
+    static constexpr int kMaxScore = 500;
+
+    virtual ~LeafEvaluator() = default;
+
+    virtual void reset(const Board& board) = 0;
+    virtual void place(int cell, int player) = 0;
+    virtual void remove(int cell, int player) = 0;
+
+    // From player's point of view, within +-kMaxScore
+    virtual int score(int player) const = 0;
+};
+
+#endif // LEAFEVAL_H
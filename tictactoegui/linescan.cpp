@@ -0,0 +1,267 @@
+#include "linescan.h"
+#include "bitops.h"
+#include "leafeval.h"
+#include <algorithm>
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LINESCAN_X86 1
+#include <immintrin.h>
+#endif
+
+int64_t LineCounts::rawScore() const {
+    // 4^15 times a window count does not fit an int, and the difference may be negative
+    int64_t total = 0;
+    for (int n = 1; n <= kMaxK; n++) {
+        total += int64_t(windows[0][n] - windows[1][n]) * (int64_t(1) << (2 * (n - 1)));
+    }
+    return total;
+}
+
+int LineCounts::score() const {
+    const int64_t limit = LeafEvaluator<LinePlanes>::kMaxScore;
+    return int(std::max(-limit, std::min(limit, rawScore())));
+}
+
+namespace {
+
+void scanScalar(const uint32_t* x, const uint32_t* o, const uint32_t* valid, int lines, int k, int starts,
+                LineCounts& counts) {
+    uint32_t window = k >= 32 ? 0xFFFFFFFFu : (1u << k) - 1;
+    for (int line = 0; line < lines; line++) {
+        for (int s = 0; s < starts; s++) {
+            if (!((valid[line] >> s) & 1)) {
+                continue;
+            }
+            int own_x = popCount64((x[line] >> s) & window);
+            int own_o = popCount64((o[line] >> s) & window);
+            if (own_o == 0) {
+                counts.windows[0][own_x]++;
+            }
+            if (own_x == 0) {
+                counts.windows[1][own_o]++;
+            }
+        }
+    }
+}
+
+#if LINESCAN_X86
+
+// Per-lane popcount of 32-bit words: nibble lookup with pshufb, then the
+// four byte counts summed by a multiply into the top byte
+__attribute__((target("sse4.1"))) inline __m128i popCount32x4(__m128i v) {
+    const __m128i table = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i low = _mm_set1_epi8(0x0F);
+    __m128i bytes = _mm_add_epi8(_mm_shuffle_epi8(table, _mm_and_si128(v, low)),
+                                 _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), low)));
+    return _mm_srli_epi32(_mm_mullo_epi32(bytes, _mm_set1_epi32(0x01010101)), 24);
+}
+
+__attribute__((target("sse4.1"))) void scanSSE41(const uint32_t* x, const uint32_t* o, const uint32_t* valid,
+                                                 int lines, int k, int starts, LineCounts& counts) {
+    const __m128i window = _mm_set1_epi32(int(k >= 32 ? 0xFFFFFFFFu : (1u << k) - 1));
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i histogram[2][LineCounts::kMaxK + 1];
+    for (int n = 0; n <= LineCounts::kMaxK; n++) {
+        histogram[0][n] = histogram[1][n] = zero;
+    }
+    for (int line = 0; line < lines; line += 4) {
+        __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + line));
+        __m128i vo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(o + line));
+        __m128i vv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(valid + line));
+        for (int s = 0; s < starts; s++) {
+            __m128i shift = _mm_cvtsi32_si128(s);
+            __m128i own_x = popCount32x4(_mm_and_si128(_mm_srl_epi32(vx, shift), window));
+            __m128i own_o = popCount32x4(_mm_and_si128(_mm_srl_epi32(vo, shift), window));
+            __m128i fits = _mm_cmpeq_epi32(_mm_and_si128(_mm_srl_epi32(vv, shift), one), one);
+            __m128i x_only = _mm_and_si128(fits, _mm_cmpeq_epi32(own_o, zero));
+            __m128i o_only = _mm_and_si128(fits, _mm_cmpeq_epi32(own_x, zero));
+            for (int n = 0; n <= k; n++) {
+                __m128i count = _mm_set1_epi32(n);
+                // Matching lanes are -1, so subtracting counts them
+                histogram[0][n] = _mm_sub_epi32(histogram[0][n], _mm_and_si128(x_only, _mm_cmpeq_epi32(own_x, count)));
+                histogram[1][n] = _mm_sub_epi32(histogram[1][n], _mm_and_si128(o_only, _mm_cmpeq_epi32(own_o, count)));
+            }
+        }
+    }
+    for (int side = 0; side < 2; side++) {
+        for (int n = 0; n <= k; n++) {
+            alignas(16) int32_t lanes[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), histogram[side][n]);
+            counts.windows[side][n] += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        }
+    }
+}
+
+__attribute__((target("avx2"))) inline __m256i popCount32x8(__m256i v) {
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(v, low)),
+                                    _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+    return _mm256_srli_epi32(_mm256_mullo_epi32(bytes, _mm256_set1_epi32(0x01010101)), 24);
+}
+
+__attribute__((target("avx2"))) void scanAVX2(const uint32_t* x, const uint32_t* o, const uint32_t* valid,
+                                              int lines, int k, int starts, LineCounts& counts) {
+    const __m256i window = _mm256_set1_epi32(int(k >= 32 ? 0xFFFFFFFFu : (1u << k) - 1));
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i zero = _mm256_setzero_si256();
+    // Kept as plain int32 lanes with unaligned access: MinGW does not align
+    // the stack for __m256i locals, and 34 vectors would spill anyway
+    int32_t histogram[2][LineCounts::kMaxK + 1][8] = {};
+    for (int line = 0; line < lines; line += 8) {
+        __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + line));
+        __m256i vo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(o + line));
+        __m256i vv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(valid + line));
+        for (int s = 0; s < starts; s++) {
+            __m128i shift = _mm_cvtsi32_si128(s);
+            __m256i own_x = popCount32x8(_mm256_and_si256(_mm256_srl_epi32(vx, shift), window));
+            __m256i own_o = popCount32x8(_mm256_and_si256(_mm256_srl_epi32(vo, shift), window));
+            __m256i fits = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_srl_epi32(vv, shift), one), one);
+            __m256i x_only = _mm256_and_si256(fits, _mm256_cmpeq_epi32(own_o, zero));
+            __m256i o_only = _mm256_and_si256(fits, _mm256_cmpeq_epi32(own_x, zero));
+            for (int n = 0; n <= k; n++) {
+                __m256i count = _mm256_set1_epi32(n);
+                __m256i* x_lanes = reinterpret_cast<__m256i*>(histogram[0][n]);
+                __m256i* o_lanes = reinterpret_cast<__m256i*>(histogram[1][n]);
+                _mm256_storeu_si256(x_lanes, _mm256_sub_epi32(_mm256_loadu_si256(x_lanes),
+                                                              _mm256_and_si256(x_only, _mm256_cmpeq_epi32(own_x, count))));
+                _mm256_storeu_si256(o_lanes, _mm256_sub_epi32(_mm256_loadu_si256(o_lanes),
+                                                              _mm256_and_si256(o_only, _mm256_cmpeq_epi32(own_o, count))));
+            }
+        }
+    }
+    for (int side = 0; side < 2; side++) {
+        for (int n = 0; n <= k; n++) {
+            for (int32_t lane : histogram[side][n]) {
+                counts.windows[side][n] += lane;
+            }
+        }
+    }
+}
+
+#endif // LINESCAN_X86
+
+ScanKernel detectKernel() {
+#if LINESCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return ScanKernel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return ScanKernel::SSE41;
+    }
+#endif
+    return ScanKernel::Scalar;
+}
+
+std::atomic<int> selectedKernel(-1); // -1 until the first scan
+
+} // namespace
+
+bool scanKernelSupported(ScanKernel kernel) {
+    static const ScanKernel best = detectKernel();
+    return int(kernel) <= int(best);
+}
+
+ScanKernel activeScanKernel() {
+    int kernel = selectedKernel.load(std::memory_order_relaxed);
+    if (kernel < 0) {
+        kernel = int(detectKernel());
+        selectedKernel.store(kernel, std::memory_order_relaxed);
+    }
+    return ScanKernel(kernel);
+}
+
+void setScanKernel(ScanKernel kernel) {
+    selectedKernel.store(int(scanKernelSupported(kernel) ? kernel : ScanKernel::Scalar), std::memory_order_relaxed);
+}
+
+void scanLineWindows(const uint32_t* x, const uint32_t* o, const uint32_t* valid, int lines, int k, int starts,
+                     LineCounts& counts) {
+    std::fill(&counts.windows[0][0], &counts.windows[0][0] + 2 * (LineCounts::kMaxK + 1), 0);
+#if LINESCAN_X86
+    ScanKernel kernel = activeScanKernel();
+    if (kernel == ScanKernel::AVX2) {
+        scanAVX2(x, o, valid, lines, k, starts, counts);
+        return;
+    } else if (kernel == ScanKernel::SSE41) {
+        scanSSE41(x, o, valid, lines, k, starts, counts);
+        return;
+    }
+#endif
+    scanScalar(x, o, valid, lines, k, starts, counts);
+}
+
+LinePlanes::LinePlanes(int rows, int cols, int k)
+    : rowCount(rows), colCount(cols), winLength(k), cellLine(size_t(rows * cols) * 4, -1),
+      cellBit(size_t(rows * cols) * 4, 0) {
+    // Walk every line from its first cell; keep the ones K fits in
+    const int directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+    int longest = 0;
+    for (int dir = 0; dir < 4; dir++) {
+        int dr = directions[dir][0];
+        int dc = directions[dir][1];
+        for (int cell = 0; cell < rows * cols; cell++) {
+            int r = cell / cols;
+            int c = cell % cols;
+            int pr = r - dr;
+            int pc = c - dc;
+            if (pr >= 0 && pr < rows && pc >= 0 && pc < cols) {
+                continue; // Not the first cell of its line
+            }
+            int length = 0;
+            while (r + dr * length < rows && c + dc * length >= 0 && c + dc * length < cols) {
+                length++;
+            }
+            if (length < k) {
+                continue;
+            }
+            int line = int(valid.size());
+            for (int i = 0; i < length; i++) {
+                int on_line = (r + dr * i) * cols + c + dc * i;
+                cellLine[size_t(on_line * 4 + dir)] = line;
+                cellBit[size_t(on_line * 4 + dir)] = i;
+            }
+            valid.push_back(length - k + 1 >= 32 ? 0xFFFFFFFFu : (1u << (length - k + 1)) - 1);
+            longest = std::max(longest, length);
+        }
+    }
+    starts = std::max(0, longest - k + 1);
+    valid.resize((valid.size() + 7) / 8 * 8, 0); // Whole vectors for the kernels
+    xLines.assign(valid.size(), 0);
+    oLines.assign(valid.size(), 0);
+}
+
+void LinePlanes::clear() {
+    std::fill(xLines.begin(), xLines.end(), 0);
+    std::fill(oLines.begin(), oLines.end(), 0);
+}
+
+void LinePlanes::place(int cell, int player) {
+    std::vector<uint32_t>& lines = player > 0 ? xLines : oLines;
+    for (int dir = 0; dir < 4; dir++) {
+        int line = cellLine[size_t(cell * 4 + dir)];
+        if (line >= 0) {
+            lines[size_t(line)] |= 1u << cellBit[size_t(cell * 4 + dir)];
+        }
+    }
+}
+
+void LinePlanes::remove(int cell, int player) {
+    std::vector<uint32_t>& lines = player > 0 ? xLines : oLines;
+    for (int dir = 0; dir < 4; dir++) {
+        int line = cellLine[size_t(cell * 4 + dir)];
+        if (line >= 0) {
+            lines[size_t(line)] &= ~(1u << cellBit[size_t(cell * 4 + dir)]);
+        }
+    }
+}
+
+LineCounts LinePlanes::scan() const {
+    LineCounts counts;
+    scanLineWindows(xLines.data(), oLines.data(), valid.data(), lines(), winLength, starts, counts);
+    return counts;
+}
@@ -0,0 +1,85 @@
+#ifndef LINESCAN_H
+#define LINESCAN_H
+
+#include <cstdint>
+#include <vector>
+
+// Windows of K cells holding stones of one side only, by side and stone
+// count: windows[0][n] for player 1, windows[1][n] for player 2 (empty
+// windows appear under both as n = 0). Only the stone count is kept, not
+// whether the cells beyond the window are free.
+struct LineCounts {
+    static const int kMaxK = 16;
+    int32_t windows[2][kMaxK + 1];
+
+    // Sum of 4^(n - 1) per window, player 1 minus player 2: the same value
+    // PatternEvaluator keeps incrementally
+    int64_t rawScore() const;
+
+    // rawScore clamped to +-LeafEvaluator::kMaxScore, like PatternEvaluator::score(1)
+    int score() const;
+};
+
+// Kernels for scanLineWindows. The best one the CPU supports is picked on
+// first use; setScanKernel overrides it (tests and benchmarks), falling
+// back to the scalar kernel if the CPU lacks the instructions.
+enum class ScanKernel {
+    Scalar,
+    SSE41, // 4 lines per step
+    AVX2   // 8 lines per step
+};
+
+ScanKernel activeScanKernel();
+bool scanKernelSupported(ScanKernel kernel);
+void setScanKernel(ScanKernel kernel);
+
+// Counts every window of k <= LineCounts::kMaxK cells in lines packed one
+// per 32-bit word: bit i of x[line] / o[line] is cell i of that line for
+// each side, and bit s of valid[line] is set when a window starting at cell
+// s fits. lines must be a multiple of 8 (pad with zero words); starts is
+// the largest number of windows in any line.
+void scanLineWindows(const uint32_t* x, const uint32_t* o, const uint32_t* valid, int lines, int k, int starts,
+                     LineCounts& counts);
+
+// The board as rotated bitplanes: every row, column and diagonal long
+// enough to hold K gets one 32-bit word per side, kept up to date by place
+// and remove, so a full evaluation is one scanLineWindows call. Rows and
+// columns up to 32 cells.
+class LinePlanes {
+public:
+    LinePlanes(int rows, int cols, int k);
+
+    template <class Board>
+    void load(const Board& board) {
+        clear();
+        for (int cell = 0; cell < rowCount * colCount; cell++) {
+            int value = board.getValue(cell / colCount, cell % colCount);
+            if (value != 0) {
+                place(cell, value);
+            }
+        }
+    }
+
+    void clear();
+    void place(int cell, int player);
+    void remove(int cell, int player);
+    LineCounts scan() const;
+
+    int lines() const { return int(valid.size()); } // padded to a multiple of 8
+    int windowStarts() const { return starts; }
+    const uint32_t* plane(int player) const { return player > 0 ? xLines.data() : oLines.data(); }
+    const uint32_t* validStarts() const { return valid.data(); }
+
+private:
+    int rowCount;
+    int colCount;
+    int winLength;
+    int starts = 0;
+    std::vector<uint32_t> xLines;
+    std::vector<uint32_t> oLines;
+    std::vector<uint32_t> valid;
+    std::vector<int> cellLine; // cell * 4 + direction: line index, -1 if too short
+    std::vector<int> cellBit;  // cell * 4 + direction: position along that line
+};
+
+#endif // LINESCAN_H
@@ -0,0 +1,51 @@
+#ifndef LINEWINDOWS_H
+#define LINEWINDOWS_H
+
+#include <cstddef>
+#include <vector>
+
+// Every run of K cells along a row, column or diagonal of a rows x cols
+// board: the windows a k-in-a-row line can be made in. Shared by the
+// searches and evaluators that reason about lines rather than single
+// cells.
+struct LineWindows {
+    int rows = 0;
+    int cols = 0;
+    int k = 0;
+    std::vector<int> cells;                // K cells per window, in line order
+    std::vector<std::vector<int>> through; // per cell: window * K + position of the cell
+
+    int count() const { return k == 0 ? 0 : int(cells.size()) / k; }
+
+    // Rebuilds for a board of that size; false if it already matched
+    bool build(int rowCount, int colCount, int winLength) {
+        if (rowCount == rows && colCount == cols && winLength == k) {
+            return false;
+        }
+        rows = rowCount;
+        cols = colCount;
+        k = winLength;
+        cells.clear();
+        through.assign(size_t(rows * cols), std::vector<int>());
+        const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        for (const auto& dir : directions) {
+            for (int row = 0; row < rows; row++) {
+                for (int col = 0; col < cols; col++) {
+                    int end_row = row + dir[0] * (k - 1);
+                    int end_col = col + dir[1] * (k - 1);
+                    if (end_row >= rows || end_col < 0 || end_col >= cols) {
+                        continue;
+                    }
+                    for (int i = 0; i < k; i++) {
+                        int cell = (row + dir[0] * i) * cols + col + dir[1] * i;
+                        through[size_t(cell)].push_back(int(cells.size()));
+                        cells.push_back(cell);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+};
+
+#endif // LINEWINDOWS_H
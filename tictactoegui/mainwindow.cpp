@@ -284,6 +284,7 @@ MainWindow::~MainWindow() {
     delete ui;  // Clean up UI components
 }
 void MainWindow::initializeGame() {
+    ai.newGame(); // Drop positions cached during the previous game
 
 
 
@@ -347,6 +348,8 @@ void MainWindow::handleButtonClick()// Slot to handle button clicks.
 
 void MainWindow::makeAIMove()//Slot for AI's move.
 {
+    // Easy and Medium play MCTS on a playout budget, Hard searches exactly
+    ai.setSearchMode(aiDifficulty == Difficulty::Hard ? SearchMode::MakeUnmake : SearchMode::MCTS);
      ai.makeMove(board);//Make the AI move.
     updateBoardUI();// Update the game board UI.
     if (checkGameState()) {
@@ -728,6 +731,18 @@ void MainWindow::onPVEButtonClicked()
     // Logic to start a Player vs AI game
     QMessageBox::information(this, "PVE", "Player vs AI mode selected!");
     againstAI=1;
+    // Let the player pick how hard the AI thinks (defaults to Hard)
+    QString level = QInputDialog::getItem(this, tr("Difficulty"),
+                                          tr("Choose the AI difficulty:"),
+                                          QStringList() << "Easy" << "Medium" << "Hard", 2, false, &ok);
+    if (ok && level == "Easy") {
+        aiDifficulty = Difficulty::Easy;
+    } else if (ok && level == "Medium") {
+        aiDifficulty = Difficulty::Medium;
+    } else {
+        aiDifficulty = Difficulty::Hard;
+    }
+    ai.setDifficulty(aiDifficulty);
     // Navigate to the actual game frame for PvE
      ui->stackedWidget->setCurrentIndex(6);
      initializeGame();
@@ -63,6 +63,7 @@ private:
     // Tic Tac Toe game logic
     GameBoard board;
     AIPlayer ai;
+    Difficulty aiDifficulty = Difficulty::Hard;
     int currentPlayer;
    /// 3x3 board for the game
 
@@ -0,0 +1,317 @@
+#ifndef MCTSSEARCH_H
+#define MCTSSEARCH_H
+
+#include "boardsearch.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// What the last MCTS search did
+struct MCTSStats {
+    uint64_t playouts = 0;
+    uint32_t treeNodes = 0;   // nodes in the pool after the search
+    uint32_t reusedNodes = 0; // kept from the previous move's tree
+    uint32_t rootVisits = 0;  // including visits inherited with the subtree
+    double winRate = 0;       // of the chosen move, for the side to move (draw = 0.5)
+};
+
+// Monte Carlo Tree Search with UCT selection and uniformly random
+// playouts. Works on the same boards as BoardSearch; on MNKBoard and
+// GameBoard the playouts run on the bitboards through play and
+// checkWinAfter.
+//
+// Nodes live in one pool and the children of a node are contiguous, so a
+// node is 16 bytes and holds no pointers. A leaf gets its children once it
+// has been visited expandVisits times, which keeps the pool small on
+// 15x15 boards; once the pool is full the tree stops growing and the
+// search goes on with playouts only.
+//
+// The tree survives between calls: when the new position is the old root
+// plus this engine's move and the opponent's reply, that subtree is copied
+// to the front of a fresh pool and the search continues from it.
+template <class Board>
+class MCTSSearch {
+public:
+    explicit MCTSSearch(uint32_t maxNodes = 1 << 22, uint32_t expandVisits = 2, uint64_t seed = 0x9E3779B97F4A7C15ull)
+        : nodeLimit(maxNodes), expandThreshold(expandVisits), rng(seed | 1) {}
+
+    // Best cell for player, stopping after limits.timeMs or limits.nodes
+    // playouts (at least one must be set); -1 if the game is over
+    int bestMove(const Board& board, int player, const SearchLimits& limits) {
+        stats = MCTSStats();
+        if (board.checkWin() != 0) {
+            return -1;
+        }
+        auto start = std::chrono::steady_clock::now();
+        if (!reuseTree(board, player)) {
+            pool.clear();
+            pool.push_back(Node());
+            setRoot(board);
+            rootPlayer = player;
+        }
+        stats.reusedNodes = uint32_t(pool.size()) - 1;
+        scratch.resize(size_t(board.cells()));
+
+        for (;;) {
+            if ((stats.playouts & 15) == 0) {
+                if (limits.nodes != 0 && stats.playouts >= limits.nodes) {
+                    break;
+                }
+                if (limits.timeMs != 0 &&
+                    std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(limits.timeMs)) {
+                    break;
+                }
+                if (limits.nodes == 0 && limits.timeMs == 0 && stats.playouts >= 10000) {
+                    break; // No budget given
+                }
+            }
+            iterate();
+            stats.playouts++;
+        }
+
+        // Most visited move: more robust than the best average
+        const Node& root = pool[0];
+        int best = -1;
+        for (uint32_t i = 0; i < root.childCount; i++) {
+            const Node& child = pool[root.firstChild + i];
+            if (best == -1 || child.visits > pool[uint32_t(best)].visits) {
+                best = int(root.firstChild + i);
+            }
+        }
+        stats.treeNodes = uint32_t(pool.size());
+        stats.rootVisits = root.visits;
+        if (best == -1) {
+            for (int cell = 0; cell < board.cells(); cell++) {
+                if (board.isEmpty(cell)) {
+                    return cell; // Tree could not grow: any legal move
+                }
+            }
+            return -1;
+        }
+        const Node& chosen = pool[uint32_t(best)];
+        stats.winRate = chosen.visits == 0 ? 0.0 : chosen.wins / chosen.visits;
+        lastMove = chosen.move;
+        return chosen.move;
+    }
+
+    // Forget the tree, e.g. for a new game
+    void reset() {
+        pool.clear();
+        lastMove = -1;
+    }
+
+    void setExploration(double c) { exploration = c; }
+
+    const MCTSStats& lastSearch() const { return stats; }
+
+private:
+    struct Node {
+        uint32_t firstChild = 0; // 0: no children yet (the root is never a child)
+        uint16_t childCount = 0;
+        int16_t move = -1;       // cell played to reach this node
+        uint32_t visits = 0;
+        float wins = 0;          // for the player who made move; draws count half
+    };
+
+    // One selection, expansion, playout and backup
+    void iterate() {
+        Board board = *rootBoard;
+        path.clear();
+        path.push_back(0);
+        uint32_t index = 0;
+        int to_move = rootPlayer;
+        int result = 0;
+        for (;;) {
+            Node& node = pool[index];
+            if (node.childCount == 0) {
+                if (node.visits + 1 < expandThreshold || !expand(index, board)) {
+                    break; // Leaf: play out from here
+                }
+            }
+            index = select(index);
+            board.play(pool[index].move, to_move);
+            path.push_back(index);
+            result = board.checkWinAfter(pool[index].move);
+            to_move = -to_move;
+            if (result != 0) {
+                break; // The game ended inside the tree
+            }
+        }
+        if (result == 0) {
+            result = playout(board, to_move);
+        }
+        // The root's mover is the side that is not to move at the root
+        int mover = -rootPlayer;
+        for (uint32_t visited : path) {
+            Node& node = pool[visited];
+            node.visits++;
+            if (result == mover) {
+                node.wins += 1.0f;
+            } else if (result != -mover) {
+                node.wins += 0.5f; // Draw
+            }
+            mover = -mover;
+        }
+    }
+
+    // Children for every empty cell; false if the pool is full or there
+    // are none
+    bool expand(uint32_t index, const Board& board) {
+        uint32_t first = uint32_t(pool.size());
+        for (int cell = 0; cell < board.cells(); cell++) {
+            if (board.isEmpty(cell)) {
+                if (pool.size() >= nodeLimit) {
+                    pool.resize(first); // Full: leave this node a leaf
+                    return false;
+                }
+                Node child;
+                child.move = int16_t(cell);
+                pool.push_back(child);
+            }
+        }
+        pool[index].firstChild = first;
+        pool[index].childCount = uint16_t(pool.size() - first);
+        return pool[index].childCount != 0;
+    }
+
+    // UCT: unvisited children first, then mean + c * sqrt(ln N / n)
+    uint32_t select(uint32_t index) const {
+        const Node& node = pool[index];
+        double log_visits = std::log(double(node.visits) + 1.0);
+        uint32_t best = node.firstChild;
+        double best_value = -1.0;
+        for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; i++) {
+            const Node& child = pool[i];
+            if (child.visits == 0) {
+                return i;
+            }
+            double value = child.wins / child.visits + exploration * std::sqrt(log_visits / child.visits);
+            if (value > best_value) {
+                best_value = value;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // Random moves to the end; returns the winner, or 2 for a draw
+    int playout(Board& board, int to_move) {
+        int count = 0;
+        for (int cell = 0; cell < board.cells(); cell++) {
+            if (board.isEmpty(cell)) {
+                scratch[size_t(count++)] = cell;
+            }
+        }
+        while (count > 0) {
+            int pick = int(nextRandom() % uint64_t(count));
+            int cell = scratch[size_t(pick)];
+            scratch[size_t(pick)] = scratch[size_t(--count)];
+            board.play(cell, to_move);
+            int result = board.checkWinAfter(cell);
+            if (result != 0) {
+                return result;
+            }
+            to_move = -to_move;
+        }
+        return 2;
+    }
+
+    // Finds the new position below the old root (this engine's move, then
+    // the reply) and moves that subtree to the front of a fresh pool
+    bool reuseTree(const Board& board, int player) {
+        if (pool.empty() || lastMove < 0 || player != rootPlayer || board.cells() != rootBoard->cells()) {
+            return false;
+        }
+        int reply = -1;
+        for (int cell = 0; cell < board.cells(); cell++) {
+            bool was_empty = rootBoard->isEmpty(cell);
+            if (!was_empty && board.isEmpty(cell)) {
+                return false; // Not a continuation of the old game
+            }
+            if (was_empty && !board.isEmpty(cell) && cell != lastMove) {
+                if (reply != -1) {
+                    return false; // More than one new stone besides ours
+                }
+                reply = cell;
+            }
+        }
+        Board expected = *rootBoard;
+        expected.play(lastMove, rootPlayer);
+        if (reply == -1 || expected.checkWinAfter(lastMove) != 0) {
+            return false;
+        }
+        expected.play(reply, -rootPlayer);
+        if (expected.hash() != board.hash()) {
+            return false; // Same cells, different owners
+        }
+        uint32_t node = findChild(0, lastMove);
+        node = node == 0 ? 0 : findChild(node, reply);
+        if (node == 0) {
+            return false;
+        }
+
+        // Breadth-first copy keeps every child block contiguous
+        spare.clear();
+        spare.push_back(pool[node]);
+        for (size_t i = 0; i < spare.size(); i++) {
+            Node copy = spare[i];
+            if (copy.childCount != 0) {
+                uint32_t first = uint32_t(spare.size());
+                for (uint32_t c = 0; c < copy.childCount; c++) {
+                    spare.push_back(pool[copy.firstChild + c]);
+                }
+                spare[i].firstChild = first;
+            }
+        }
+        std::swap(pool, spare);
+        pool[0].move = -1;
+        setRoot(board);
+        return true;
+    }
+
+    // Boards such as GridBoard have no default constructor, so the root is
+    // created from the first position searched
+    void setRoot(const Board& board) {
+        if (rootBoard) {
+            *rootBoard = board;
+        } else {
+            rootBoard.reset(new Board(board));
+        }
+    }
+
+    uint32_t findChild(uint32_t index, int move) const {
+        const Node& node = pool[index];
+        for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; i++) {
+            if (pool[i].move == move) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    // xorshift64*: plenty for playouts, and far cheaper than std::mt19937_64
+    uint64_t nextRandom() {
+        rng ^= rng >> 12;
+        rng ^= rng << 25;
+        rng ^= rng >> 27;
+        return rng * 0x2545F4914F6CDD1Dull;
+    }
+
+    std::vector<Node> pool;
+    std::vector<Node> spare;       // target of the subtree copy, reused
+    std::vector<uint32_t> path;    // nodes visited by the current iteration
+    std::vector<int> scratch;      // empty cells during a playout
+    std::unique_ptr<Board> rootBoard; // set by the first bestMove
+    int rootPlayer = 1;
+    int lastMove = -1;             // move this engine returned last
+    uint32_t nodeLimit;
+    uint32_t expandThreshold;
+    double exploration = 1.41421356;
+    uint64_t rng;
+    MCTSStats stats;
+};
+
+#endif // MCTSSEARCH_H
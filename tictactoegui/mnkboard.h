@@ -0,0 +1,210 @@
+#ifndef MNKBOARD_H
+#define MNKBOARD_H
+
+#include "bitops.h"
+#include "zobrist.h"
+#include <array>
+#include <cstdint>
+#include <iostream>
+
+// Fixed-size set of board cells stored as 64-bit words
+template <int Words>
+struct BoardMask {
+    uint64_t words[Words];
+
+    constexpr BoardMask() : words() {}
+
+    constexpr void set(int bit) { words[bit >> 6] |= uint64_t(1) << (bit & 63); }
+    constexpr void reset(int bit) { words[bit >> 6] &= ~(uint64_t(1) << (bit & 63)); }
+    constexpr bool test(int bit) const { return (words[bit >> 6] >> (bit & 63)) & 1; }
+
+    // True if every cell of line is also in this mask
+    constexpr bool contains(const BoardMask& line) const {
+        for (int i = 0; i < Words; ++i) {
+            if ((words[i] & line.words[i]) != line.words[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int count() const {
+        int total = 0;
+        for (int i = 0; i < Words; ++i) {
+            total += popCount64(words[i]);
+        }
+        return total;
+    }
+};
+
+// Compile-time geometry of an m,n,k board: every line of K cells as a mask,
+// and for each cell the indices of the lines passing through it
+template <int Rows, int Cols, int K>
+struct MNKGeometry {
+    static constexpr int kCells = Rows * Cols;
+    static constexpr int kWords = (kCells + 63) / 64;
+    static constexpr int kMaxLinesPerCell = 4 * K;
+    using Mask = BoardMask<kWords>;
+
+    // Calls visit(first cell, row step, col step) for every line on the board
+    template <class Visit>
+    static constexpr void forEachLine(Visit visit) {
+        const int directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+        for (const auto& d : directions) {
+            for (int r = 0; r < Rows; ++r) {
+                for (int c = 0; c < Cols; ++c) {
+                    int endRow = r + d[0] * (K - 1);
+                    int endCol = c + d[1] * (K - 1);
+                    if (endRow < Rows && endCol >= 0 && endCol < Cols) {
+                        visit(r * Cols + c, d[0], d[1]);
+                    }
+                }
+            }
+        }
+    }
+
+    static constexpr int countLines() {
+        int count = 0;
+        forEachLine([&count](int, int, int) { count++; });
+        return count;
+    }
+
+    static constexpr int kLines = countLines();
+
+    struct CellLines {
+        int count;
+        int index[kMaxLinesPerCell];
+    };
+
+    std::array<Mask, kLines> lines;
+    std::array<CellLines, kCells> cellLines;
+
+    static constexpr MNKGeometry make() {
+        MNKGeometry geometry{};
+        int next = 0;
+        forEachLine([&geometry, &next](int start, int dr, int dc) {
+            for (int i = 0; i < K; ++i) {
+                int cell = start + (dr * Cols + dc) * i;
+                geometry.lines[next].set(cell);
+                CellLines& through = geometry.cellLines[cell];
+                through.index[through.count++] = next;
+            }
+            next++;
+        });
+        return geometry;
+    }
+};
+
+// Board for the m,n,k-game: Rows x Cols cells, K in a row wins. Line masks
+// and the lines through each cell are generated at compile time, so every
+// instantiation gets win checks specialized to its own geometry.
+template <int Rows, int Cols, int K>
+class MNKBoard {
+public:
+    static constexpr int kRows = Rows;
+    static constexpr int kCols = Cols;
+    static constexpr int kWinLength = K;
+    static constexpr int kCells = Rows * Cols;
+    using Geometry = MNKGeometry<Rows, Cols, K>;
+    using Mask = typename Geometry::Mask;
+    static constexpr int kLines = Geometry::kLines;
+
+    static_assert(Rows > 0 && Cols > 0 && K > 0, "board needs cells and a win length");
+    static_assert(K <= Rows || K <= Cols, "no line of length K fits on the board");
+
+    MNKBoard() : stoneCount(0), zobrist(0) {}
+
+    void display() const {
+        for (int i = 0; i < Rows; ++i) {
+            for (int j = 0; j < Cols; ++j) {
+                int value = getValue(i, j);
+                std::cout << (value == 1 ? "X " : value == -1 ? "O " : "- ");
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    // 1 or -1 for the side with K in a row, 2 for a draw, 0 if not over
+    int checkWin() const {
+        for (const Mask& line : lines) {
+            if (xMask.contains(line)) {
+                return 1;
+            }
+            if (oMask.contains(line)) {
+                return -1;
+            }
+        }
+        return stoneCount == kCells ? 2 : 0;
+    }
+
+    // Same result as checkWin() when cell holds the last stone played,
+    // looking only at the lines through that cell
+    int checkWinAfter(int cell) const {
+        int player = xMask.test(cell) ? 1 : oMask.test(cell) ? -1 : 0;
+        if (player != 0) {
+            const Mask& own = player > 0 ? xMask : oMask;
+            const auto& through = geometry.cellLines[cell];
+            for (int i = 0; i < through.count; ++i) {
+                if (own.contains(lines[through.index[i]])) {
+                    return player;
+                }
+            }
+        }
+        return stoneCount == kCells ? 2 : 0;
+    }
+
+    int getValue(int row, int col) const {
+        if (row < 0 || row >= Rows || col < 0 || col >= Cols) {
+            return 0;
+        }
+        int cell = row * Cols + col;
+        return xMask.test(cell) ? 1 : oMask.test(cell) ? -1 : 0;
+    }
+
+    void setValue(int row, int col, int value) {
+        if (row < 0 || row >= Rows || col < 0 || col >= Cols) {
+            return;
+        }
+        int cell = row * Cols + col;
+        if (!isEmpty(cell)) {
+            undo(cell);
+        }
+        if (value != 0) {
+            play(cell, value > 0 ? 1 : -1);
+        }
+    }
+
+    bool isEmpty(int cell) const { return !xMask.test(cell) && !oMask.test(cell); }
+
+    void play(int cell, int player) {
+        (player > 0 ? xMask : oMask).set(cell);
+        zobrist ^= ZobristKeys<kCells>::key(cell, player);
+        stoneCount++;
+    }
+
+    void undo(int cell) {
+        int player = xMask.test(cell) ? 1 : -1;
+        (player > 0 ? xMask : oMask).reset(cell);
+        zobrist ^= ZobristKeys<kCells>::key(cell, player);
+        stoneCount--;
+    }
+
+    static constexpr int cells() { return kCells; }
+    static constexpr int rows() { return kRows; }
+    static constexpr int cols() { return kCols; }
+    static constexpr int k() { return kWinLength; }
+    uint64_t hash() const { return zobrist; }
+    const Mask& mask(int player) const { return player > 0 ? xMask : oMask; }
+    int stones() const { return stoneCount; }
+
+    static constexpr Geometry geometry = Geometry::make();
+    static constexpr const std::array<Mask, kLines>& lines = geometry.lines;
+
+private:
+    Mask xMask; // Cells of player 1 (value 1)
+    Mask oMask; // Cells of player 2 (value -1)
+    int stoneCount;
+    uint64_t zobrist;
+};
+
+#endif // MNKBOARD_H
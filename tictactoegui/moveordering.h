@@ -0,0 +1,136 @@
+#ifndef MOVEORDERING_H
+#define MOVEORDERING_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Move ordering state for one searching thread: the transposition-table
+// move first, then the two killer moves of the ply, then by history score,
+// with the number of winning lines through a cell (center > corner > edge
+// on 3x3) breaking ties. BoardSearch keeps one, and every YBWC worker keeps
+// its own, so killers and history are never shared between threads.
+class MoveOrdering {
+public:
+    // Off: the table move first, then plain board order (for comparisons)
+    void setEnabled(bool on) { enabled = on; }
+
+    // Sizes the per-ply and per-cell tables, and the static prior, for board
+    template <class Board>
+    void prepare(const Board& board) {
+        int cells = board.cells();
+        if (board.rows() == priorRows && board.cols() == priorCols && board.k() == priorK) {
+            return;
+        }
+        priorRows = board.rows();
+        priorCols = board.cols();
+        priorK = board.k();
+        killers.assign(size_t(cells + 2), std::array<int, 2>{ { -1, -1 } });
+        history[0].assign(size_t(cells), 0);
+        history[1].assign(size_t(cells), 0);
+        // Prior: number of k-in-a-row windows that pass through each cell
+        const int kDirections[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+        prior.assign(size_t(cells), 0);
+        for (int cell = 0; cell < cells; cell++) {
+            int row = cell / priorCols;
+            int col = cell % priorCols;
+            for (const auto& dir : kDirections) {
+                for (int offset = 0; offset < priorK; offset++) {
+                    int first_row = row - offset * dir[0];
+                    int first_col = col - offset * dir[1];
+                    int last_row = first_row + (priorK - 1) * dir[0];
+                    int last_col = first_col + (priorK - 1) * dir[1];
+                    if (first_row >= 0 && first_col >= 0 && first_col < priorCols &&
+                        last_row < priorRows && last_col >= 0 && last_col < priorCols) {
+                        prior[size_t(cell)]++;
+                    }
+                }
+            }
+            prior[size_t(cell)] = std::min(prior[size_t(cell)], 255);
+        }
+    }
+
+    // Start of a search: age history so older searches weigh less, forget killers
+    void age() {
+        for (int side = 0; side < 2; side++) {
+            for (uint32_t& score : history[side]) {
+                score >>= 1;
+            }
+        }
+        std::fill(killers.begin(), killers.end(), std::array<int, 2>{ { -1, -1 } });
+    }
+
+    void clearHistory() {
+        history[0].assign(history[0].size(), 0);
+        history[1].assign(history[1].size(), 0);
+    }
+
+    // Fills moves with (sort key << 32 | cell) for every empty cell; side is
+    // 0 for player 1 and 1 for player 2, ply the distance from the root
+    template <class Board>
+    int generate(const Board& board, int tt_move, int side, int ply, std::vector<uint64_t>& moves) const {
+        const uint32_t kTableMove = 0xFFFFFFFFu;
+        const uint32_t kFirstKiller = 0xFFFFFFFEu;
+        const uint32_t kSecondKiller = 0xFFFFFFFDu;
+        int count = 0;
+        int cells = board.cells();
+        for (int cell = 0; cell < cells; cell++) {
+            if (!board.isEmpty(cell)) {
+                continue;
+            }
+            uint32_t order;
+            if (cell == tt_move) {
+                order = kTableMove;
+            } else if (!enabled) {
+                order = uint32_t(cells - cell); // Board order
+            } else if (cell == killers[size_t(ply)][0]) {
+                order = kFirstKiller;
+            } else if (cell == killers[size_t(ply)][1]) {
+                order = kSecondKiller;
+            } else {
+                order = (std::min<uint32_t>(history[side][size_t(cell)], 0xFFFFFF) << 8) | uint32_t(prior[size_t(cell)]);
+            }
+            moves[size_t(count++)] = (uint64_t(order) << 32) | uint32_t(cell);
+        }
+        return count;
+    }
+
+    // Moves the best remaining entry to index i; cheaper than sorting when
+    // a cutoff comes early
+    static int pick(std::vector<uint64_t>& moves, int i, int count) {
+        int best = i;
+        for (int j = i + 1; j < count; j++) {
+            if (moves[size_t(j)] > moves[size_t(best)]) {
+                best = j;
+            }
+        }
+        std::swap(moves[size_t(i)], moves[size_t(best)]);
+        return int(moves[size_t(i)] & 0xFFFFFFFFu);
+    }
+
+    // cell failed high at ply with depth plies left
+    void recordCutoff(int cell, int side, int ply, int depth) {
+        if (!enabled) {
+            return;
+        }
+        std::array<int, 2>& slot = killers[size_t(ply)];
+        if (slot[0] != cell) {
+            slot[1] = slot[0];
+            slot[0] = cell;
+        }
+        history[side][size_t(cell)] = std::min<uint32_t>(history[side][size_t(cell)] + uint32_t(depth * depth), 0xFFFFFF);
+    }
+
+private:
+    bool enabled = true;
+    std::vector<std::array<int, 2>> killers; // last two cutoff moves per ply
+    std::vector<uint32_t> history[2]; // per side and cell, grows with depth^2 on cutoffs
+    std::vector<int> prior; // static per-cell score
+    int priorRows = 0;
+    int priorCols = 0;
+    int priorK = 0;
+};
+
+#endif // MOVEORDERING_H
@@ -0,0 +1,212 @@
+#include "nnueeval.h"
+#include "linescan.h"
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NNUEEVAL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const char kMagic[8] = { 'T', 'T', 'T', 'N', 'N', 'U', 'E', '1' };
+const int kMaxCells = 32 * 32;
+
+struct NNUEHeader {
+    char magic[8];
+    uint32_t cells;
+    uint32_t hidden;
+    uint32_t dense;
+};
+
+template <class T>
+bool readArray(std::ifstream& in, std::vector<T>& values, size_t count) {
+    values.resize(count);
+    in.read(reinterpret_cast<char*>(values.data()), std::streamsize(count * sizeof(T)));
+    return bool(in);
+}
+
+template <class T>
+void writeArray(std::ofstream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), std::streamsize(values.size() * sizeof(T)));
+}
+
+// Final layer, shared by every kernel so they round alike
+int outputLayer(const uint8_t* hidden, const int8_t* weights, int32_t bias) {
+    int32_t sum = bias;
+    for (int j = 0; j < NNUEWeights::kDense; j++) {
+        sum += hidden[j] * weights[j];
+    }
+    return sum / NNUEWeights::kOutputScale;
+}
+
+uint8_t clipHidden(int32_t sum) {
+    return uint8_t(std::max(0, std::min(127, sum >> NNUEWeights::kDenseShift)));
+}
+
+void denseScalar(const int16_t* us, const int16_t* them, const int8_t* weights, const int32_t* bias,
+                 uint8_t* hidden) {
+    uint8_t input[NNUEWeights::kInputs];
+    for (int i = 0; i < NNUEWeights::kHidden; i++) {
+        input[i] = uint8_t(std::max(0, std::min(127, int(us[i]))));
+        input[NNUEWeights::kHidden + i] = uint8_t(std::max(0, std::min(127, int(them[i]))));
+    }
+    for (int j = 0; j < NNUEWeights::kDense; j++) {
+        const int8_t* row = weights + j * NNUEWeights::kInputs;
+        int32_t sum = bias[j];
+        for (int i = 0; i < NNUEWeights::kInputs; i++) {
+            sum += input[i] * row[i];
+        }
+        hidden[j] = clipHidden(sum);
+    }
+}
+
+#if NNUEEVAL_X86
+
+// Clipped inputs as 64 unsigned bytes in four registers, then per output
+// row pmaddubsw (u8 * i8 pairs, at most 2 * 127 * 128, no saturation) and
+// pmaddwd into int32
+__attribute__((target("sse4.1"))) void denseSSE41(const int16_t* us, const int16_t* them, const int8_t* weights,
+                                                  const int32_t* bias, uint8_t* hidden) {
+    const __m128i clip = _mm_set1_epi8(127);
+    const __m128i ones = _mm_set1_epi16(1);
+    const int16_t* halves[2] = { us, them };
+    __m128i input[4];
+    for (int h = 0; h < 2; h++) {
+        for (int part = 0; part < 2; part++) {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(halves[h] + part * 16));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(halves[h] + part * 16 + 8));
+            input[h * 2 + part] = _mm_min_epu8(_mm_packus_epi16(low, high), clip);
+        }
+    }
+    for (int j = 0; j < NNUEWeights::kDense; j++) {
+        const int8_t* row = weights + j * NNUEWeights::kInputs;
+        __m128i sum = _mm_setzero_si128();
+        for (int part = 0; part < 4; part++) {
+            __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + part * 16));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(input[part], w), ones));
+        }
+        sum = _mm_hadd_epi32(sum, sum);
+        sum = _mm_hadd_epi32(sum, sum);
+        hidden[j] = clipHidden(bias[j] + _mm_cvtsi128_si32(sum));
+    }
+}
+
+// 32 accumulator values clipped to [0, 127] as bytes, in order
+__attribute__((target("avx2"))) inline __m256i clipInputs32(const int16_t* values) {
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + 16));
+    // packus interleaves the 128-bit halves; the permute puts them back in order
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+    return _mm256_min_epu8(packed, _mm256_set1_epi8(127));
+}
+
+__attribute__((target("avx2"))) void denseAVX2(const int16_t* us, const int16_t* them, const int8_t* weights,
+                                               const int32_t* bias, uint8_t* hidden) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    // Two named registers rather than an array, which MinGW could place unaligned
+    const __m256i own = clipInputs32(us);
+    const __m256i other = clipInputs32(them);
+    for (int j = 0; j < NNUEWeights::kDense; j++) {
+        const int8_t* row = weights + j * NNUEWeights::kInputs;
+        __m256i w0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row));
+        __m256i w1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + 32));
+        __m256i sum = _mm256_add_epi32(_mm256_madd_epi16(_mm256_maddubs_epi16(own, w0), ones),
+                                       _mm256_madd_epi16(_mm256_maddubs_epi16(other, w1), ones));
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_hadd_epi32(half, half);
+        half = _mm_hadd_epi32(half, half);
+        hidden[j] = clipHidden(bias[j] + _mm_cvtsi128_si32(half));
+    }
+}
+
+#endif // NNUEEVAL_X86
+
+} // namespace
+
+bool NNUEWeights::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    NNUEHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0
+        || header.cells == 0 || header.cells > uint32_t(kMaxCells)
+        || header.hidden != uint32_t(kHidden) || header.dense != uint32_t(kDense)) {
+        return false;
+    }
+    NNUEWeights loaded;
+    loaded.cellCount = int(header.cells);
+    if (!readArray(in, loaded.transform, size_t(2 * loaded.cellCount) * kHidden)
+        || !readArray(in, loaded.transformBias, kHidden)
+        || !readArray(in, loaded.denseWeights, size_t(kDense) * kInputs)
+        || !readArray(in, loaded.denseBias, kDense)
+        || !readArray(in, loaded.outputWeights, kDense)
+        || !in.read(reinterpret_cast<char*>(&loaded.outputBias), sizeof(loaded.outputBias))
+        || in.peek() != std::ifstream::traits_type::eof()) {
+        return false; // Truncated, or trailing bytes: not this architecture
+    }
+    *this = std::move(loaded);
+    return true;
+}
+
+bool NNUEWeights::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    NNUEHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.cells = uint32_t(cellCount);
+    header.hidden = uint32_t(kHidden);
+    header.dense = uint32_t(kDense);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeArray(out, transform);
+    writeArray(out, transformBias);
+    writeArray(out, denseWeights);
+    writeArray(out, denseBias);
+    writeArray(out, outputWeights);
+    out.write(reinterpret_cast<const char*>(&outputBias), sizeof(outputBias));
+    return bool(out);
+}
+
+void NNUEWeights::randomize(int cells, uint32_t seed) {
+    std::mt19937 rng(seed);
+    auto uniform = [&rng](int low, int high) { return low + int(rng() % uint32_t(high - low + 1)); };
+    cellCount = cells;
+    transform.resize(size_t(2 * cells) * kHidden);
+    for (int16_t& weight : transform) {
+        weight = int16_t(uniform(-8, 8));
+    }
+    transformBias.resize(kHidden);
+    for (int16_t& weight : transformBias) {
+        weight = int16_t(uniform(0, 64));
+    }
+    denseWeights.resize(size_t(kDense) * kInputs);
+    for (int8_t& weight : denseWeights) {
+        weight = int8_t(uniform(-64, 64));
+    }
+    denseBias.resize(kDense);
+    for (int32_t& weight : denseBias) {
+        weight = uniform(-512, 512);
+    }
+    outputWeights.resize(kDense);
+    for (int8_t& weight : outputWeights) {
+        weight = int8_t(uniform(-16, 16));
+    }
+    outputBias = 0;
+}
+
+int NNUEWeights::forward(const int16_t* us, const int16_t* them) const {
+    uint8_t hidden[kDense];
+#if NNUEEVAL_X86
+    ScanKernel kernel = activeScanKernel();
+    if (kernel == ScanKernel::AVX2) {
+        denseAVX2(us, them, denseWeights.data(), denseBias.data(), hidden);
+        return outputLayer(hidden, outputWeights.data(), outputBias);
+    } else if (kernel == ScanKernel::SSE41) {
+        denseSSE41(us, them, denseWeights.data(), denseBias.data(), hidden);
+        return outputLayer(hidden, outputWeights.data(), outputBias);
+    }
+#endif
+    denseScalar(us, them, denseWeights.data(), denseBias.data(), hidden);
+    return outputLayer(hidden, outputWeights.data(), outputBias);
+}
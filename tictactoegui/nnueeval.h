@@ -0,0 +1,130 @@
+#ifndef NNUEEVAL_H
+#define NNUEEVAL_H
+
+#include "leafeval.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Weights of a small NNUE-style network, loaded from a flat binary file:
+//
+//   feature transformer  2 * cells -> kHidden, int16, one row per feature
+//   dense layer          2 * kHidden -> kDense, int8 weights, int32 bias
+//   output               kDense -> 1, int8 weights, int32 bias
+//
+// Features are seen from one side: feature cell is "own stone on cell",
+// feature cells + cell "opponent stone on cell". Each side keeps its own
+// accumulator of transformer rows; the dense layer reads the side to move's
+// one, then the other, both clipped to [0, 127].
+//
+// The file is a 20-byte header ("TTTNNUE1", then cells, kHidden and kDense
+// as uint32) followed by the arrays above in that order, little-endian.
+class NNUEWeights {
+public:
+    static const int kHidden = 32;
+    static const int kInputs = 2 * kHidden;
+    static const int kDense = 16;
+    static const int kDenseShift = 6;   // dense sums are scaled down by 2^6 before clipping
+    static const int kOutputScale = 16; // network units per score point
+
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    // Small random weights for cells; tests and benchmarks, not for play
+    void randomize(int cells, uint32_t seed);
+
+    bool isLoaded() const { return cellCount > 0; }
+    int cells() const { return cellCount; }
+
+    const int16_t* featureRow(int feature) const { return &transform[size_t(feature) * kHidden]; }
+    const int16_t* bias() const { return transformBias.data(); }
+
+    // Score in points for the side owning us, from both accumulators. Runs
+    // the dense layer with the kernel the line scanner picked.
+    int forward(const int16_t* us, const int16_t* them) const;
+
+private:
+    int cellCount = 0;
+    std::vector<int16_t> transform;     // [2 * cells][kHidden]
+    std::vector<int16_t> transformBias; // [kHidden]
+    std::vector<int8_t> denseWeights;   // [kDense][kInputs]
+    std::vector<int32_t> denseBias;     // [kDense]
+    std::vector<int8_t> outputWeights;  // [kDense]
+    int32_t outputBias = 0;
+};
+
+// Leaf evaluator running an NNUEWeights network. place and remove add or
+// subtract one transformer row per side, so a leaf costs only the two
+// small dense layers. Without weights sized for the board it scores 0.
+template <class Board>
+class NNUEEvaluator final : public LeafEvaluator<Board> {
+public:
+    using LeafEvaluator<Board>::kMaxScore;
+
+    explicit NNUEEvaluator(const NNUEWeights* net = nullptr) : weights(net) {}
+
+    // The weights must outlive the evaluator; reset before the next use
+    void setWeights(const NNUEWeights* net) {
+        weights = net;
+        active = false;
+    }
+
+    void reset(const Board& board) override {
+        cells = board.cells();
+        active = weights != nullptr && weights->cells() == cells;
+        if (!active) {
+            return;
+        }
+        std::copy(weights->bias(), weights->bias() + NNUEWeights::kHidden, accumulator[0]);
+        std::copy(weights->bias(), weights->bias() + NNUEWeights::kHidden, accumulator[1]);
+        int cols = board.cols();
+        for (int cell = 0; cell < cells; cell++) {
+            int value = board.getValue(cell / cols, cell % cols);
+            if (value != 0) {
+                place(cell, value);
+            }
+        }
+    }
+
+    void place(int cell, int player) override {
+        if (active) {
+            update(cell, player, 1);
+        }
+    }
+
+    void remove(int cell, int player) override {
+        if (active) {
+            update(cell, player, -1);
+        }
+    }
+
+    int score(int player) const override {
+        if (!active) {
+            return 0;
+        }
+        int side = player > 0 ? 0 : 1;
+        int value = weights->forward(accumulator[side], accumulator[1 - side]);
+        return std::max(-kMaxScore, std::min(kMaxScore, value));
+    }
+
+    // Accumulator seen from player's side; mainly for tests
+    const int16_t* accumulatorFor(int player) const { return accumulator[player > 0 ? 0 : 1]; }
+
+private:
+    void update(int cell, int player, int sign) {
+        // Player 1's stone is "own" for side 0 and "opponent" for side 1
+        const int16_t* first = weights->featureRow(player > 0 ? cell : cells + cell);
+        const int16_t* second = weights->featureRow(player > 0 ? cells + cell : cell);
+        for (int i = 0; i < NNUEWeights::kHidden; i++) {
+            accumulator[0][i] = int16_t(accumulator[0][i] + sign * first[i]);
+            accumulator[1][i] = int16_t(accumulator[1][i] + sign * second[i]);
+        }
+    }
+
+    const NNUEWeights* weights;
+    int cells = 0;
+    bool active = false;
+    int16_t accumulator[2][NNUEWeights::kHidden] = {}; // read unaligned by the kernels
+};
+
+#endif // NNUEEVAL_H
@@ -0,0 +1,296 @@
+#ifndef PARALLELMCTS_H
+#define PARALLELMCTS_H
+
+#include "boardsearch.h"
+#include "mctssearch.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Tree-parallel MCTS: every thread of a persistent pool runs UCT
+// iterations on one shared tree.
+//
+// Node counters are relaxed atomics and nothing takes a lock. A thread
+// passing through a node bumps its pending count; selection treats each
+// pending visit as virtualLoss lost playouts, which steers the other
+// threads onto different paths until the playout is backed up. A leaf is
+// expanded by the thread that wins a compare-exchange on firstChild and
+// claims a block of the preallocated pool with fetch_add; the others just
+// play out from the leaf meanwhile. The children are published with a
+// release store, so a reader that sees firstChild also sees them.
+//
+// Unlike MCTSSearch the tree is rebuilt for every move.
+template <class Board>
+class ParallelMCTSSearch {
+public:
+    explicit ParallelMCTSSearch(int threads = 0, uint32_t maxNodes = 1 << 22, uint32_t expandVisits = 2,
+                                uint64_t seed = 0x9E3779B97F4A7C15ull)
+        : pool(threads), nodes(new Node[maxNodes]), nodeLimit(maxNodes),
+          expandThreshold(expandVisits), seed(seed) {
+        for (int i = 0; i < pool.size(); i++) {
+            workers.emplace_back(new Worker());
+        }
+    }
+
+    int threads() const { return pool.size(); }
+
+    // Best cell for player, stopping after limits.timeMs or limits.nodes
+    // playouts in total; -1 if the game is over
+    int bestMove(const Board& board, int player, const SearchLimits& limits) {
+        stats = MCTSStats();
+        if (board.checkWin() != 0) {
+            return -1;
+        }
+        // Boards such as GridBoard have no default constructor, so the root
+        // is created from the first position searched
+        if (rootBoard) {
+            *rootBoard = board;
+        } else {
+            rootBoard.reset(new Board(board));
+        }
+        rootPlayer = player;
+        initNode(0, -1);
+        used = 1;
+        claimed = 0;
+        stop = false;
+        auto start = std::chrono::steady_clock::now();
+        deadline = start + std::chrono::milliseconds(limits.timeMs);
+        budget = limits;
+        if (limits.nodes == 0 && limits.timeMs == 0) {
+            budget.nodes = 10000; // No budget given
+        }
+
+        pool.run([this](int index) { workerLoop(*workers[size_t(index)], index); });
+
+        const Node& root = nodes[0];
+        uint32_t first = root.firstChild.load(std::memory_order_acquire);
+        int best = -1;
+        for (uint32_t i = 0; first != 0 && first != kExpanding && i < root.childCount; i++) {
+            if (best == -1 || nodes[first + i].visits > nodes[uint32_t(best)].visits) {
+                best = int(first + i);
+            }
+        }
+        for (auto& worker : workers) {
+            stats.playouts += worker->playouts;
+        }
+        stats.treeNodes = std::min(used.load(), nodeLimit);
+        stats.rootVisits = root.visits;
+        if (best == -1) {
+            for (int cell = 0; cell < board.cells(); cell++) {
+                if (board.isEmpty(cell)) {
+                    return cell; // Tree could not grow: any legal move
+                }
+            }
+            return -1;
+        }
+        const Node& chosen = nodes[uint32_t(best)];
+        stats.winRate = chosen.visits == 0 ? 0.0 : 0.5 * chosen.halfWins / chosen.visits;
+        return chosen.move;
+    }
+
+    // Playouts run by each thread in the last search
+    uint64_t threadPlayouts(int index) const { return workers[size_t(index)]->playouts; }
+
+    void setExploration(double c) { exploration = c; }
+    void setVirtualLoss(uint32_t loss) { virtualLoss = loss; }
+
+    const MCTSStats& lastSearch() const { return stats; }
+
+private:
+    static constexpr uint32_t kExpanding = 0xFFFFFFFFu; // firstChild while a thread expands
+
+    struct Node {
+        std::atomic<uint32_t> firstChild{0}; // 0: leaf, kExpanding: being expanded
+        uint16_t childCount = 0;             // written before firstChild is published
+        int16_t move = -1;
+        std::atomic<uint32_t> visits{0};
+        std::atomic<uint32_t> halfWins{0};   // for the player who made move: win 2, draw 1
+        std::atomic<uint32_t> pending{0};    // threads below this node right now
+    };
+
+    struct Worker {
+        std::vector<uint32_t> path;
+        std::vector<int> scratch;
+        uint64_t rng = 1;
+        uint64_t playouts = 0;
+    };
+
+    void initNode(uint32_t index, int move) {
+        Node& node = nodes[index];
+        node.firstChild.store(0, std::memory_order_relaxed);
+        node.childCount = 0;
+        node.move = int16_t(move);
+        node.visits.store(0, std::memory_order_relaxed);
+        node.halfWins.store(0, std::memory_order_relaxed);
+        node.pending.store(0, std::memory_order_relaxed);
+    }
+
+    void workerLoop(Worker& worker, int index) {
+        worker.rng = (seed ^ (uint64_t(index) * 0xD1B54A32D192ED03ull)) | 1;
+        worker.playouts = 0;
+        worker.scratch.resize(size_t(rootBoard->cells()));
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (budget.nodes != 0 && claimed.fetch_add(1, std::memory_order_relaxed) >= budget.nodes) {
+                stop = true;
+                break;
+            }
+            if (budget.timeMs != 0 && (worker.playouts & 15) == 0 && std::chrono::steady_clock::now() >= deadline) {
+                stop = true;
+                break;
+            }
+            iterate(worker);
+            worker.playouts++;
+        }
+    }
+
+    void iterate(Worker& worker) {
+        Board board = *rootBoard;
+        worker.path.clear();
+        worker.path.push_back(0);
+        nodes[0].pending.fetch_add(1, std::memory_order_relaxed);
+        uint32_t index = 0;
+        int to_move = rootPlayer;
+        int result = 0;
+        for (;;) {
+            Node& node = nodes[index];
+            uint32_t first = node.firstChild.load(std::memory_order_acquire);
+            if (first == 0) {
+                if (node.visits.load(std::memory_order_relaxed) + 1 < expandThreshold) {
+                    break;
+                }
+                first = expand(index, board);
+            }
+            if (first == 0 || first == kExpanding) {
+                break; // Leaf, or another thread is expanding it: play out from here
+            }
+            index = select(node, first);
+            nodes[index].pending.fetch_add(1, std::memory_order_relaxed);
+            board.play(nodes[index].move, to_move);
+            worker.path.push_back(index);
+            result = board.checkWinAfter(nodes[index].move);
+            to_move = -to_move;
+            if (result != 0) {
+                break;
+            }
+        }
+        if (result == 0) {
+            result = playout(worker, board, to_move);
+        }
+        int mover = -rootPlayer;
+        for (uint32_t visited : worker.path) {
+            Node& node = nodes[visited];
+            if (result == mover) {
+                node.halfWins.fetch_add(2, std::memory_order_relaxed);
+            } else if (result != -mover) {
+                node.halfWins.fetch_add(1, std::memory_order_relaxed);
+            }
+            node.visits.fetch_add(1, std::memory_order_relaxed);
+            node.pending.fetch_sub(1, std::memory_order_relaxed);
+            mover = -mover;
+        }
+    }
+
+    // Claims the node and allocates its children; returns firstChild as
+    // seen afterwards (0 if the pool is full, kExpanding if another thread
+    // got there first)
+    uint32_t expand(uint32_t index, const Board& board) {
+        Node& node = nodes[index];
+        uint32_t expected = 0;
+        if (used.load(std::memory_order_relaxed) >= nodeLimit ||
+            !node.firstChild.compare_exchange_strong(expected, kExpanding, std::memory_order_acquire)) {
+            return expected;
+        }
+        uint32_t count = 0;
+        for (int cell = 0; cell < board.cells(); cell++) {
+            count += board.isEmpty(cell) ? 1 : 0;
+        }
+        uint32_t first = used.fetch_add(count, std::memory_order_relaxed);
+        if (count == 0 || first + count > nodeLimit) {
+            node.firstChild.store(0, std::memory_order_release); // Full: stays a leaf
+            return 0;
+        }
+        uint32_t next = first;
+        for (int cell = 0; cell < board.cells(); cell++) {
+            if (board.isEmpty(cell)) {
+                initNode(next++, cell);
+            }
+        }
+        node.childCount = uint16_t(count);
+        node.firstChild.store(first, std::memory_order_release);
+        return first;
+    }
+
+    // UCT where each pending visit counts as virtualLoss lost playouts
+    uint32_t select(const Node& node, uint32_t first) const {
+        double parent = double(node.visits.load(std::memory_order_relaxed)) +
+                        double(node.pending.load(std::memory_order_relaxed)) * virtualLoss;
+        double log_visits = std::log(parent + 1.0);
+        uint32_t best = first;
+        double best_value = -1.0;
+        for (uint32_t i = first; i < first + node.childCount; i++) {
+            const Node& child = nodes[i];
+            uint32_t visits = child.visits.load(std::memory_order_relaxed);
+            uint32_t pending = child.pending.load(std::memory_order_relaxed);
+            if (visits + pending == 0) {
+                return i;
+            }
+            double n = double(visits) + double(pending) * virtualLoss;
+            double value = 0.5 * child.halfWins.load(std::memory_order_relaxed) / n +
+                           exploration * std::sqrt(log_visits / n);
+            if (value > best_value) {
+                best_value = value;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    int playout(Worker& worker, Board& board, int to_move) {
+        int count = 0;
+        for (int cell = 0; cell < board.cells(); cell++) {
+            if (board.isEmpty(cell)) {
+                worker.scratch[size_t(count++)] = cell;
+            }
+        }
+        while (count > 0) {
+            // xorshift64*, one stream per thread
+            worker.rng ^= worker.rng >> 12;
+            worker.rng ^= worker.rng << 25;
+            worker.rng ^= worker.rng >> 27;
+            int pick = int((worker.rng * 0x2545F4914F6CDD1Dull) % uint64_t(count));
+            int cell = worker.scratch[size_t(pick)];
+            worker.scratch[size_t(pick)] = worker.scratch[size_t(--count)];
+            board.play(cell, to_move);
+            int result = board.checkWinAfter(cell);
+            if (result != 0) {
+                return result;
+            }
+            to_move = -to_move;
+        }
+        return 2;
+    }
+
+    ThreadPool pool;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::unique_ptr<Node[]> nodes;
+    uint32_t nodeLimit;
+    uint32_t expandThreshold;
+    uint64_t seed;
+    std::atomic<uint32_t> used{0};      // nodes handed out, may overshoot nodeLimit
+    std::atomic<uint64_t> claimed{0};   // playouts started, against budget.nodes
+    std::atomic<bool> stop{false};
+    std::chrono::steady_clock::time_point deadline;
+    SearchLimits budget;
+    std::unique_ptr<Board> rootBoard; // set by the first bestMove
+    int rootPlayer = 1;
+    double exploration = 1.41421356;
+    uint32_t virtualLoss = 3;
+    MCTSStats stats;
+};
+
+#endif // PARALLELMCTS_H
@@ -0,0 +1,208 @@
+#ifndef PARALLELSEARCH_H
+#define PARALLELSEARCH_H
+
+#include "boardsearch.h"
+#include "threadpool.h"
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// Iterative deepening that splits the root moves across a persistent
+// thread pool. Workers take moves from a shared counter and search them
+// with their own BoardSearch (own table, killers and history) on their own
+// copy of the board. The best score so far is shared, so later moves only
+// need to prove they can match it.
+//
+// The result does not depend on timing: each move is searched with the
+// window (best - 1, +inf), so every move that ties for best gets an exact
+// score, and ties go to the lowest cell, as in the serial BoardSearch.
+// Tables are cleared per call so stale deeper entries cannot change the
+// values.
+template <class Board>
+class ParallelSearch {
+public:
+    explicit ParallelSearch(int threads = 0, size_t tableEntries = 1 << 16) : pool(threads) {
+        for (int i = 0; i < pool.size(); i++) {
+            engines.emplace_back(new BoardSearch<Board>(tableEntries));
+        }
+    }
+
+    int threads() const { return pool.size(); }
+
+    // Score unfinished leaves with a PatternEvaluator per worker instead of 0,
+    // as the serial engine does with one attached
+    void usePatternEvaluation(bool enabled) {
+        if (enabled && evaluators.empty()) {
+            for (size_t i = 0; i < engines.size(); i++) {
+                evaluators.emplace_back(new PatternEvaluator<Board>());
+            }
+        }
+        for (size_t i = 0; i < engines.size(); i++) {
+            engines[i]->setEvaluator(enabled ? evaluators[i].get() : nullptr);
+        }
+    }
+
+    int bestMove(const Board& board, int player, const SearchLimits& limits) {
+        stats = SearchStats();
+        if (board.checkWin() != 0) {
+            return -1;
+        }
+        // Workers share the time budget; each gets its slice of the nodes
+        SearchLimits worker_limits = limits;
+        if (limits.nodes != 0) {
+            worker_limits.nodes = std::max<uint64_t>(1, limits.nodes / uint64_t(threads()));
+        }
+        for (auto& engine : engines) {
+            engine->clear();
+            engine->beginSearch(board, player, worker_limits);
+        }
+        std::vector<int> moves;
+        for (int cell = 0; cell < board.cells(); cell++) {
+            if (board.isEmpty(cell)) {
+                moves.push_back(cell);
+            }
+        }
+
+        int best_cell = -1;
+        std::vector<int> scores(moves.size());
+        for (int depth = 1; depth <= limits.maxDepth; depth++) {
+            // Start from the previous best move, as the serial search does
+            for (size_t i = 1; best_cell != -1 && i < moves.size(); i++) {
+                if (moves[i] == best_cell) {
+                    std::swap(moves[0], moves[i]);
+                }
+            }
+            std::atomic<size_t> next(0);
+            std::atomic<int> shared_best(std::numeric_limits<int>::min());
+            std::atomic<bool> stopped(false);
+            pool.run([&](int worker) {
+                Board local = board;
+                BoardSearch<Board>& engine = *engines[worker];
+                for (size_t i = next++; i < moves.size() && !stopped; i = next++) {
+                    int best = shared_best.load();
+                    int alpha = best == std::numeric_limits<int>::min() ? best : best - 1;
+                    int score = engine.scoreMove(local, player, moves[i], depth - 1, alpha);
+                    if (engine.stoppedEarly()) {
+                        stopped = true;
+                        break;
+                    }
+                    scores[i] = score;
+                    while (score > best && !shared_best.compare_exchange_weak(best, score)) {
+                    }
+                }
+            });
+            stats.nodes = 0;
+            for (auto& engine : engines) {
+                stats.nodes += engine->lastSearch().nodes;
+            }
+            if (stopped) {
+                break;
+            }
+            int best_score = std::numeric_limits<int>::min();
+            best_cell = -1;
+            for (size_t i = 0; i < moves.size(); i++) {
+                if (best_cell == -1 || scores[i] > best_score || (scores[i] == best_score && moves[i] < best_cell)) {
+                    best_score = scores[i];
+                    best_cell = moves[i];
+                }
+            }
+            stats.depth = depth;
+            stats.score = best_score;
+            if (depth >= int(moves.size()) || best_score == BoardSearch<Board>::kWinScore ||
+                best_score == -BoardSearch<Board>::kWinScore) {
+                break;
+            }
+        }
+        if (best_cell == -1) {
+            best_cell = moves.empty() ? -1 : moves[0];
+        }
+        return best_cell;
+    }
+
+    // Nodes summed over all workers
+    const SearchStats& lastSearch() const { return stats; }
+
+private:
+    ThreadPool pool;
+    std::vector<std::unique_ptr<BoardSearch<Board>>> engines;
+    std::vector<std::unique_ptr<PatternEvaluator<Board>>> evaluators; // one per engine, once enabled
+    SearchStats stats;
+};
+
+// Lazy SMP: every worker runs the full iterative-deepening search on the
+// same root and they share one lock-free transposition table, so results
+// found by one thread cut the trees of the others. Helpers are made to
+// diverge from the main thread: odd helpers start one ply deeper and each
+// tries the root moves from a different cell. The main thread (worker 0)
+// decides the move and stops the helpers when it finishes. Unlike
+// ParallelSearch, the result may vary between runs when scores tie.
+template <class Board>
+class LazySMPSearch {
+public:
+    explicit LazySMPSearch(int threads = 0, size_t tableEntries = 1 << 20) : pool(threads), table(tableEntries) {
+        for (int i = 0; i < pool.size(); i++) {
+            engines.emplace_back(new BoardSearch<Board>(1));
+            engines.back()->shareTable(&table);
+            engines.back()->setStopFlag(&stop);
+        }
+    }
+
+    int threads() const { return pool.size(); }
+
+    // Score unfinished leaves with a PatternEvaluator per worker instead of 0,
+    // as the serial engine does with one attached
+    void usePatternEvaluation(bool enabled) {
+        if (enabled && evaluators.empty()) {
+            for (size_t i = 0; i < engines.size(); i++) {
+                evaluators.emplace_back(new PatternEvaluator<Board>());
+            }
+        }
+        for (size_t i = 0; i < engines.size(); i++) {
+            engines[i]->setEvaluator(enabled ? evaluators[i].get() : nullptr);
+        }
+    }
+
+    int bestMove(const Board& board, int player, const SearchLimits& limits) {
+        stop = false;
+        int best_cell = -1;
+        for (auto& engine : engines) {
+            engine->setMaxPlayer(player); // Clears the shared table if the side changed
+        }
+        pool.run([&](int worker) {
+            Board local = board;
+            BoardSearch<Board>& engine = *engines[worker];
+            SearchLimits worker_limits = limits;
+            if (worker > 0) {
+                worker_limits.startDepth = 1 + worker % 2;
+                engine.setRootOffset(worker);
+            }
+            int cell = engine.bestMove(local, player, worker_limits);
+            if (worker == 0) {
+                best_cell = cell;
+                stop = true; // Helpers notice within a few hundred nodes
+            }
+        });
+        stats = engines[0]->lastSearch();
+        stats.nodes = 0;
+        for (auto& engine : engines) {
+            stats.nodes += engine->lastSearch().nodes;
+        }
+        return best_cell;
+    }
+
+    // Depth and score of the main thread, nodes summed over all workers
+    const SearchStats& lastSearch() const { return stats; }
+
+    void clear() { table.clear(); }
+
+private:
+    ThreadPool pool;
+    TranspositionTable table;
+    std::atomic<bool> stop{ false };
+    std::vector<std::unique_ptr<BoardSearch<Board>>> engines;
+    std::vector<std::unique_ptr<PatternEvaluator<Board>>> evaluators; // one per engine, once enabled
+    SearchStats stats;
+};
+
+#endif // PARALLELSEARCH_H
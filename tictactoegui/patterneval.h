@@ -0,0 +1,92 @@
+#ifndef PATTERNEVAL_H
+#define PATTERNEVAL_H
+
+#include "leafeval.h"
+#include "linewindows.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Heuristic value of an unfinished k-in-a-row position. Each window of K
+// cells is read as a base-3 number (digit 0 empty, 1 player 1, 2 player 2)
+// and looked up in a table of 3^K pattern scores: a window held by one
+// side with n stones is worth 4^(n - 1) to that side, a window with both
+// sides in it is dead and worth nothing.
+//
+// The window indices and their sum are kept up to date by place and
+// remove, which touch only the windows through the cell (at most 4K), so
+// a search can read score() at every leaf without rescanning the board.
+template <class Board>
+class PatternEvaluator final : public LeafEvaluator<Board> {
+public:
+    using LeafEvaluator<Board>::kMaxScore;
+
+    // Sizes the tables for board and computes every window from scratch
+    void reset(const Board& board) override {
+        if (geometry.build(board.rows(), board.cols(), board.k())) {
+            buildTables();
+        }
+        index.assign(size_t(geometry.count()), 0);
+        total = 0;
+        for (int cell = 0; cell < board.cells(); cell++) {
+            int value = board.getValue(cell / geometry.cols, cell % geometry.cols);
+            if (value != 0) {
+                place(cell, value);
+            }
+        }
+    }
+
+    void place(int cell, int player) override { update(cell, player > 0 ? 1 : 2); }
+    void remove(int cell, int player) override { update(cell, player > 0 ? -1 : -2); }
+
+    // From player's point of view, clamped to +-kMaxScore
+    int score(int player) const override {
+        int clamped = std::max(-kMaxScore, std::min(kMaxScore, total));
+        return player > 0 ? clamped : -clamped;
+    }
+
+    // Unclamped sum for player 1
+    int rawScore() const { return total; }
+
+    // Table entry for a window index; mainly for tests
+    int patternScore(int pattern) const { return patterns[size_t(pattern)]; }
+
+private:
+    // digit is +-1 or +-2: adds or takes away that side's stone
+    void update(int cell, int digit) {
+        for (int slot : geometry.through[size_t(cell)]) {
+            uint32_t& window = index[size_t(slot / geometry.k)];
+            total -= patterns[window];
+            window = uint32_t(int(window) + digit * powers[size_t(slot % geometry.k)]);
+            total += patterns[window];
+        }
+    }
+
+    void buildTables() {
+        powers.assign(size_t(geometry.k), 1);
+        for (int i = 1; i < geometry.k; i++) {
+            powers[size_t(i)] = powers[size_t(i - 1)] * 3;
+        }
+        int size = powers.back() * 3;
+        patterns.assign(size_t(size), 0);
+        for (int pattern = 0; pattern < size; pattern++) {
+            int own[3] = {0, 0, 0};
+            for (int rest = pattern; rest > 0; rest /= 3) {
+                own[rest % 3]++;
+            }
+            if (own[1] > 0 && own[2] == 0) {
+                patterns[size_t(pattern)] = 1 << (2 * (own[1] - 1));
+            } else if (own[2] > 0 && own[1] == 0) {
+                patterns[size_t(pattern)] = -(1 << (2 * (own[2] - 1)));
+            }
+        }
+    }
+
+    LineWindows geometry;
+    std::vector<int> powers;     // 3^position within a window
+    std::vector<int> patterns;   // score of each of the 3^K window indices
+    std::vector<uint32_t> index; // current index of each window
+    int total = 0;
+};
+
+#endif // PATTERNEVAL_H
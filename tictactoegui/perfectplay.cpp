@@ -0,0 +1,96 @@
+#include "perfectplay.h"
+#include <array>
+
+namespace {
+
+const int kPositions = 19683; // 3^9 encodings, see GameBoard::encode
+
+// Entry layout: bits 0-8 optimal moves, 9-10 value + 1, 11-14 distance, 15 solved
+const uint16_t kSolved = 0x8000;
+
+constexpr int entryValue(uint16_t entry) { return int((entry >> 9) & 3) - 1; }
+constexpr int entryDistance(uint16_t entry) { return (entry >> 11) & 15; }
+constexpr uint16_t makeEntry(int value, int distance, uint16_t moves) {
+    return uint16_t(kSolved | (distance << 11) | ((value + 1) << 9) | moves);
+}
+
+struct Table {
+    std::array<uint16_t, 2 * kPositions> entries{}; // player 1 to move, then player -1
+    std::array<bool, 512> hasLine{};                  // mask contains a winning line
+};
+
+constexpr uint16_t solve(Table& table, uint16_t xMask, uint16_t oMask, int code, int player) {
+    int slot = (player > 0 ? 0 : kPositions) + code;
+    if (table.entries[slot] & kSolved) {
+        return table.entries[slot];
+    }
+
+    uint16_t mine = player > 0 ? xMask : oMask;
+    uint16_t theirs = player > 0 ? oMask : xMask;
+    uint16_t entry = 0;
+    if (table.hasLine[theirs]) {
+        entry = makeEntry(-1, 0, 0);
+    } else if (table.hasLine[mine]) {
+        entry = makeEntry(1, 0, 0);
+    } else if ((xMask | oMask) == 0x1FF) {
+        entry = makeEntry(0, 0, 0);
+    } else {
+        int bestValue = -2;
+        int bestDistance = 0;
+        uint16_t moves = 0;
+        int pow3 = 1;
+        for (int cell = 0; cell < 9; ++cell, pow3 *= 3) {
+            uint16_t bit = uint16_t(1u << cell);
+            if ((xMask | oMask) & bit) {
+                continue;
+            }
+            uint16_t child = player > 0
+                ? solve(table, uint16_t(xMask | bit), oMask, code + pow3, -player)
+                : solve(table, xMask, uint16_t(oMask | bit), code + 2 * pow3, -player);
+            int value = -entryValue(child);
+            int distance = entryDistance(child) + 1;
+            // Prefer the better result; among equals, win fast and lose slowly
+            bool better = value > bestValue
+                || (value == bestValue && value > 0 && distance < bestDistance)
+                || (value == bestValue && value < 0 && distance > bestDistance);
+            if (better) {
+                bestValue = value;
+                bestDistance = distance;
+                moves = bit;
+            } else if (value == bestValue && distance == bestDistance) {
+                moves |= bit;
+            }
+        }
+        entry = makeEntry(bestValue, bestDistance, moves);
+    }
+    table.entries[slot] = entry;
+    return entry;
+}
+
+// Solves every position reachable in a game, whichever side moves first
+constexpr Table solveAll() {
+    Table table;
+    const uint16_t lines[8] = { 0x007, 0x038, 0x1C0, 0x049, 0x092, 0x124, 0x111, 0x054 };
+    for (int mask = 0; mask < 512; ++mask) {
+        for (uint16_t line : lines) {
+            if ((mask & line) == line) {
+                table.hasLine[mask] = true;
+            }
+        }
+    }
+    solve(table, 0, 0, 0, 1);
+    solve(table, 0, 0, 0, -1);
+    return table;
+}
+
+constexpr Table kTable = solveAll();
+
+static_assert(entryValue(kTable.entries[0]) == 0, "tic-tac-toe is a draw");
+static_assert(entryDistance(kTable.entries[0]) == 9, "a drawn game fills the board");
+
+} // namespace
+
+PerfectPlay perfectPlay(const GameBoard& board, int player) {
+    uint16_t entry = kTable.entries[(player > 0 ? 0 : kPositions) + board.encode()];
+    return PerfectPlay{ (entry & kSolved) != 0, entryValue(entry), entryDistance(entry), uint16_t(entry & 0x1FF) };
+}
@@ -0,0 +1,19 @@
+#ifndef PERFECTPLAY_H
+#define PERFECTPLAY_H
+
+#include "gameboard.h"
+#include <cstdint>
+
+// Game-theoretic value of a 3x3 position, looked up in a table solved at
+// compile time for every position reachable in a game, with either side
+// having moved first. Hand-made positions outside the table report !known.
+struct PerfectPlay {
+    bool known;
+    int value;      // 1 if the side to move wins, 0 draw, -1 loss
+    int distance;   // plies until the game ends with optimal play
+    uint16_t moves; // mask of every optimal cell (row * 3 + col), 0 if over
+};
+
+PerfectPlay perfectPlay(const GameBoard& board, int player);
+
+#endif // PERFECTPLAY_H
@@ -0,0 +1,318 @@
+#ifndef PROOFSEARCH_H
+#define PROOFSEARCH_H
+
+#include "boardsearch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Game-theoretic value of a position for the player to move
+enum class ProofResult {
+    Win,
+    Draw,
+    Loss,
+    Unknown // Budget ran out first
+};
+
+struct ProofStats {
+    uint64_t nodes = 0;       // mid() calls, both passes
+    uint32_t passes = 0;      // 1 if the win was proved outright, else 2
+    uint64_t tableEntries = 0; // in use when the search ended
+    uint32_t gcRuns = 0;
+    uint64_t collected = 0;   // entries freed by garbage collection
+};
+
+// Depth-first proof-number search (df-pn) for k-in-a-row boards.
+//
+// A pass proves or disproves "the attacker wins"; draws count against the
+// attacker. solve() first tries to prove a win for the side to move and,
+// failing that, a win for the opponent, which settles every position as
+// Win, Loss or Draw.
+//
+// Proof and disproof numbers live in a fixed-size table of 4-entry
+// buckets keyed by the Zobrist hash. Each entry also records the work
+// (nodes) spent below it. When three quarters of the table is in use, the
+// entries with the least work are dropped until half of them are free;
+// cheap subtrees are the ones cheapest to redo. A full bucket replaces its
+// least-worked entry. Numbers are kept in phi/delta form (phi is the proof
+// number for the side to move), so OR and AND nodes share one code path.
+//
+// Immediate wins and forced blocks are resolved while generating moves,
+// which keeps the branching factor of forcing lines at one or two even on
+// 15x15 boards.
+template <class Board>
+class ProofSearch {
+public:
+    explicit ProofSearch(size_t maxBytes = size_t(64) << 20) {
+        size_t buckets = 1;
+        while (buckets * 2 * sizeof(Bucket) <= maxBytes) {
+            buckets *= 2;
+        }
+        table.reset(new Bucket[buckets]);
+        bucketMask = buckets - 1;
+    }
+
+    // Value for player, to move on board; limits.nodes and limits.timeMs
+    // bound both passes together
+    ProofResult solve(const Board& board, int player, const SearchLimits& limits = SearchLimits()) {
+        stats = ProofStats();
+        best = -1;
+        int winner = board.checkWin();
+        if (winner != 0) {
+            return winner == player ? ProofResult::Win : winner == -player ? ProofResult::Loss : ProofResult::Draw;
+        }
+        budget = limits;
+        start = std::chrono::steady_clock::now();
+        aborted = false;
+        children.resize(size_t(board.cells()) + 1);
+
+        // Pass 1: can player force a win?
+        ProofResult result = ProofResult::Unknown;
+        if (prove(board, player, player)) {
+            result = ProofResult::Win;
+        } else if (!aborted) {
+            // Pass 2: can the opponent? If not, a move that holds the draw is
+            // one whose proof for the opponent failed
+            result = prove(board, player, -player) ? ProofResult::Loss : ProofResult::Draw;
+        }
+        stats.tableEntries = used;
+        if (aborted) {
+            best = -1;
+            return ProofResult::Unknown;
+        }
+        if (result == ProofResult::Loss) {
+            best = -1;
+            for (int cell = 0; cell < board.cells() && best == -1; cell++) {
+                best = board.isEmpty(cell) ? cell : -1; // Every move loses
+            }
+        }
+        return result;
+    }
+
+    // Winning move after Win, a drawing move after Draw, any move after Loss
+    int bestMove() const { return best; }
+
+    const ProofStats& lastSearch() const { return stats; }
+
+    void clear() {
+        for (size_t i = 0; i <= bucketMask; i++) {
+            table[i] = Bucket();
+        }
+        used = 0;
+    }
+
+private:
+    static constexpr uint32_t kInfinity = 0x3FFFFFFF;
+    static constexpr int kBucketSize = 4;
+
+    struct Entry {
+        uint64_t key = 0; // 0: empty
+        uint32_t phi = 0;
+        uint32_t delta = 0;
+        uint64_t work = 0;
+    };
+
+    struct Bucket {
+        Entry entries[kBucketSize];
+    };
+
+    struct Child {
+        int cell;
+        uint32_t phi;
+        uint32_t delta;
+    };
+
+    // One df-pn pass from the root; true if attacker's win is proved
+    bool prove(const Board& board, int player, int attacker) {
+        stats.passes++;
+        Board root = board;
+        uint32_t phi = 0;
+        uint32_t delta = 0;
+        mid(root, player, attacker, kInfinity, kInfinity, 0, phi, delta);
+        if (aborted) {
+            return false;
+        }
+        // The player's goal holds at the root iff phi is 0; the move that
+        // keeps it has delta 0 (disproves the opponent's goal)
+        for (const Child& child : children[0]) {
+            if (child.delta == 0) {
+                best = child.cell;
+                break;
+            }
+        }
+        return (player == attacker) == (phi == 0);
+    }
+
+    // Multiple iterative deepening: searches below board until phi or
+    // delta reaches its threshold, then reports both
+    void mid(Board& board, int to_move, int attacker, uint32_t thphi, uint32_t thdelta, int ply,
+             uint32_t& phi, uint32_t& delta) {
+        uint64_t first_node = stats.nodes++;
+        if ((stats.nodes & 1023) == 0 && outOfBudget()) {
+            aborted = true;
+        }
+        std::vector<Child>& moves = children[size_t(ply)];
+        generateMoves(board, to_move, attacker, moves);
+
+        for (;;) {
+            phi = kInfinity;
+            uint64_t sum = 0;
+            for (const Child& child : moves) {
+                phi = std::min(phi, child.delta);
+                sum += child.phi;
+            }
+            delta = uint32_t(std::min<uint64_t>(sum, kInfinity));
+            if (phi >= thphi || delta >= thdelta || aborted) {
+                break;
+            }
+            // Most promising child, and the runner-up that bounds its threshold
+            size_t best_child = 0;
+            uint32_t second = kInfinity;
+            for (size_t i = 1; i < moves.size(); i++) {
+                if (moves[i].delta < moves[best_child].delta) {
+                    second = moves[best_child].delta;
+                    best_child = i;
+                } else if (moves[i].delta < second) {
+                    second = moves[i].delta;
+                }
+            }
+            Child& child = moves[best_child];
+            uint32_t child_thphi = thdelta >= kInfinity ? kInfinity : thdelta - delta + child.phi;
+            uint32_t child_thdelta = std::min(thphi, second >= kInfinity ? kInfinity : second + 1);
+            board.play(child.cell, to_move);
+            mid(board, -to_move, attacker, child_thphi, child_thdelta, ply + 1, child.phi, child.delta);
+            board.undo(child.cell);
+        }
+        store(key(board, to_move, attacker), phi, delta, stats.nodes - first_node);
+    }
+
+    // Children with their known or initial numbers. A winning move is the
+    // only child needed; otherwise, if the opponent threatens to win on
+    // some cells, every other move loses at once, so only blocks are kept.
+    void generateMoves(Board& board, int to_move, int attacker, std::vector<Child>& moves) {
+        moves.clear();
+        for (int cell = 0; cell < board.cells(); cell++) {
+            if (!board.isEmpty(cell)) {
+                continue;
+            }
+            board.play(cell, to_move);
+            int result = board.checkWinAfter(cell);
+            board.undo(cell);
+            if (result == to_move) {
+                moves.clear();
+                moves.push_back(Child{cell, kInfinity, 0});
+                return;
+            }
+            board.play(cell, -to_move);
+            if (board.checkWinAfter(cell) == -to_move) {
+                moves.push_back(Child{cell, 1, 1}); // Must block here
+            }
+            board.undo(cell);
+        }
+        bool forced = !moves.empty();
+        for (int cell = 0; !forced && cell < board.cells(); cell++) {
+            if (board.isEmpty(cell)) {
+                moves.push_back(Child{cell, 1, 1});
+            }
+        }
+        for (Child& child : moves) {
+            board.play(child.cell, to_move);
+            if (board.checkWinAfter(child.cell) == 2) {
+                // Draw: the defender's goal
+                child.phi = to_move == attacker ? 0 : kInfinity;
+                child.delta = to_move == attacker ? kInfinity : 0;
+            } else {
+                const Entry* entry = probe(key(board, -to_move, attacker));
+                if (entry != nullptr) {
+                    child.phi = entry->phi;
+                    child.delta = entry->delta;
+                }
+            }
+            board.undo(child.cell);
+        }
+    }
+
+    bool outOfBudget() const {
+        if (budget.nodes != 0 && stats.nodes >= budget.nodes) {
+            return true;
+        }
+        return budget.timeMs != 0 &&
+               std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(budget.timeMs);
+    }
+
+    static uint64_t key(const Board& board, int to_move, int attacker) {
+        uint64_t k = board.hash() ^ (to_move == 1 ? 0x7A3C5E1B9D2F4861ull : 0) ^ (attacker == 1 ? 0xC6A4A7935BD1E995ull : 0);
+        return k == 0 ? 1 : k;
+    }
+
+    const Entry* probe(uint64_t k) const {
+        const Bucket& bucket = table[size_t(k) & bucketMask];
+        for (const Entry& entry : bucket.entries) {
+            if (entry.key == k) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    void store(uint64_t k, uint32_t phi, uint32_t delta, uint64_t work) {
+        if (used * 4 >= (bucketMask + 1) * kBucketSize * 3) {
+            collectGarbage();
+        }
+        Bucket& bucket = table[size_t(k) & bucketMask];
+        Entry* slot = nullptr;
+        for (Entry& entry : bucket.entries) {
+            if (entry.key == k) {
+                slot = &entry;
+                break;
+            }
+            if (slot == nullptr || (slot->key != 0 && (entry.key == 0 || entry.work < slot->work))) {
+                slot = &entry; // Empty slot, else the least work
+            }
+        }
+        if (slot->key != k) {
+            if (slot->key == 0) {
+                used++;
+            }
+            slot->key = k;
+            slot->work = 0;
+        }
+        slot->phi = phi;
+        slot->delta = delta;
+        slot->work += work;
+    }
+
+    // Drops entries with work at or below a doubling threshold until at
+    // least half the entries are gone
+    void collectGarbage() {
+        stats.gcRuns++;
+        uint64_t target = used / 2;
+        uint64_t freed = 0;
+        for (uint64_t threshold = 1; freed < target; threshold *= 2) {
+            for (size_t i = 0; i <= bucketMask; i++) {
+                for (Entry& entry : table[i].entries) {
+                    if (entry.key != 0 && entry.work <= threshold) {
+                        entry.key = 0;
+                        freed++;
+                    }
+                }
+            }
+        }
+        used -= freed;
+        stats.collected += freed;
+    }
+
+    std::unique_ptr<Bucket[]> table;
+    size_t bucketMask = 0;
+    uint64_t used = 0;
+    std::vector<std::vector<Child>> children; // per ply, sized once per solve
+    SearchLimits budget;
+    std::chrono::steady_clock::time_point start;
+    bool aborted = false;
+    int best = -1;
+    ProofStats stats;
+};
+
+#endif // PROOFSEARCH_H
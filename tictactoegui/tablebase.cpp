@@ -0,0 +1,423 @@
+#include "tablebase.h"
+#include "bitops.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kMagic[8] = { 'M', 'N', 'K', 'T', 'B', '0', '1', '\0' };
+
+struct TablebaseHeader {
+    char magic[8];
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t k;
+    uint32_t cells;
+    // Byte offset of each level from the start of the file; entry cells + 1 is the end
+    uint64_t levelOffset[TablebaseIndex::kMaxCells + 2];
+};
+
+// Two bits per position, four positions per byte
+int readValue(const unsigned char* level, uint64_t index) {
+    return (level[index >> 2] >> ((index & 3) * 2)) & 3;
+}
+
+struct MappedFile {
+    const unsigned char* data = nullptr;
+    size_t length = 0;
+    void* handle = nullptr;
+};
+
+bool mapFile(const std::string& path, MappedFile& file) {
+#if defined(_WIN32)
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(handle, &size) && size.QuadPart > 0) {
+        mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(handle);
+    if (!mapping) {
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    file.data = static_cast<const unsigned char*>(view);
+    file.length = size_t(size.QuadPart);
+    file.handle = mapping;
+    return true;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        view = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    file.data = static_cast<const unsigned char*>(view);
+    file.length = size_t(info.st_size);
+    return true;
+#endif
+}
+
+void unmapFile(MappedFile& file) {
+    if (!file.data) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(file.data);
+    CloseHandle(static_cast<HANDLE>(file.handle));
+#else
+    munmap(const_cast<unsigned char*>(file.data), file.length);
+#endif
+    file = MappedFile();
+}
+
+bool fail(std::string* error, const std::string& message) {
+    if (error) {
+        *error = message;
+    }
+    return false;
+}
+
+// Value of one position given the values of the next level, for the side to move
+int solvePosition(const TablebaseIndex& index, int level, uint64_t first, uint64_t second, const unsigned char* next) {
+    bool firstToMove = level % 2 == 0;
+    if (index.hasLine(firstToMove ? second : first)) {
+        return Tablebase::Loss; // The player who just moved completed a line
+    }
+    if (index.hasLine(firstToMove ? first : second)) {
+        return Tablebase::Win; // Not reachable in a real game
+    }
+    if (level == index.cells()) {
+        return Tablebase::Draw;
+    }
+    int best = Tablebase::Loss;
+    uint64_t empty = ~(first | second) & ((uint64_t(1) << index.cells()) - 1);
+    for (; empty; empty &= empty - 1) {
+        uint64_t bit = empty & (~empty + 1);
+        uint64_t child = firstToMove ? index.rank(first | bit, second) : index.rank(first, second | bit);
+        // A loss for the opponent is a win for us and the other way round
+        best = std::max(best, 2 - readValue(next, child));
+        if (best == Tablebase::Win) {
+            break;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+TablebaseIndex::TablebaseIndex(int rows, int cols, int k) : rowCount(rows), colCount(cols), winLength(k) {
+    for (int n = 0; n <= kMaxCells; n++) {
+        for (int r = 0; r <= kMaxCells; r++) {
+            binomial[n][r] = r == 0 ? 1 : n == 0 ? 0 : binomial[n - 1][r - 1] + binomial[n - 1][r];
+        }
+    }
+    const int directions[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+    for (const auto& d : directions) {
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                int endRow = r + d[0] * (k - 1);
+                int endCol = c + d[1] * (k - 1);
+                if (k < 1 || endRow >= rows || endCol < 0 || endCol >= cols) {
+                    continue;
+                }
+                uint64_t line = 0;
+                for (int i = 0; i < k; i++) {
+                    line |= uint64_t(1) << ((r + d[0] * i) * cols + c + d[1] * i);
+                }
+                lines.push_back(line);
+            }
+        }
+    }
+}
+
+uint64_t TablebaseIndex::levelSize(int level) const {
+    return choose(cells(), level) * choose(level, (level + 1) / 2);
+}
+
+uint64_t TablebaseIndex::rank(uint64_t firstMask, uint64_t secondMask) const {
+    uint64_t occupied = firstMask | secondMask;
+    int stones = popCount64(occupied);
+    uint64_t occupiedRank = 0;
+    uint64_t firstRank = 0;
+    int seen = 0;
+    int firstSeen = 0;
+    for (; occupied; occupied &= occupied - 1) {
+        int cell = lowestBit64(occupied);
+        occupiedRank += choose(cell, ++seen);
+        if (firstMask & (uint64_t(1) << cell)) {
+            firstRank += choose(seen - 1, ++firstSeen);
+        }
+    }
+    return occupiedRank * choose(stones, firstSeen) + firstRank;
+}
+
+void TablebaseIndex::unrank(int level, uint64_t index, uint64_t& firstMask, uint64_t& secondMask) const {
+    int firstCount = (level + 1) / 2;
+    uint64_t patterns = choose(level, firstCount);
+    uint64_t occupiedRank = index / patterns;
+    uint64_t firstRank = index % patterns;
+
+    // Decode the occupied cells from the top down, remembering them in order
+    int occupiedCells[kMaxCells];
+    int cell = cells();
+    for (int t = level; t >= 1; t--) {
+        do {
+            cell--;
+        } while (choose(cell, t) > occupiedRank);
+        occupiedRank -= choose(cell, t);
+        occupiedCells[t - 1] = cell;
+    }
+
+    firstMask = 0;
+    secondMask = 0;
+    int position = level;
+    bool isFirst[kMaxCells] = {};
+    for (int t = firstCount; t >= 1; t--) {
+        do {
+            position--;
+        } while (choose(position, t) > firstRank);
+        firstRank -= choose(position, t);
+        isFirst[position] = true;
+    }
+    for (int i = 0; i < level; i++) {
+        (isFirst[i] ? firstMask : secondMask) |= uint64_t(1) << occupiedCells[i];
+    }
+}
+
+bool TablebaseIndex::hasLine(uint64_t mask) const {
+    for (uint64_t line : lines) {
+        if ((mask & line) == line) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Tablebase::Tablebase() : data(nullptr), length(0), mapping(nullptr), geometry(nullptr), levelOffsets(nullptr) {
+}
+
+Tablebase::~Tablebase() {
+    close();
+}
+
+bool Tablebase::open(const std::string& path) {
+    close();
+    MappedFile file;
+    if (!mapFile(path, file)) {
+        return false;
+    }
+    const TablebaseHeader* header = reinterpret_cast<const TablebaseHeader*>(file.data);
+    bool valid = file.length >= sizeof(TablebaseHeader)
+        && std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0
+        && header->rows >= 1 && header->rows <= uint32_t(TablebaseIndex::kMaxCells)
+        && header->cols >= 1 && header->cols <= uint32_t(TablebaseIndex::kMaxCells)
+        && header->cells == header->rows * header->cols
+        && header->cells <= uint32_t(TablebaseIndex::kMaxCells)
+        && header->k >= 1 && header->k <= std::max(header->rows, header->cols)
+        && header->levelOffset[0] >= sizeof(TablebaseHeader)
+        && header->levelOffset[header->cells + 1] == file.length;
+    TablebaseIndex* index = nullptr;
+    if (valid) {
+        // probe reads every level at its offset, so each one must have exactly its packed size
+        index = new TablebaseIndex(int(header->rows), int(header->cols), int(header->k));
+        for (int level = 0; level <= index->cells() && valid; level++) {
+            uint64_t size = header->levelOffset[level + 1] - header->levelOffset[level];
+            valid = size == (index->levelSize(level) + 3) / 4;
+        }
+    }
+    if (!valid) {
+        delete index;
+        unmapFile(file);
+        return false;
+    }
+    data = file.data;
+    length = file.length;
+    mapping = file.handle;
+    geometry = index;
+    levelOffsets = header->levelOffset;
+    return true;
+}
+
+void Tablebase::close() {
+    MappedFile file;
+    file.data = data;
+    file.length = length;
+    file.handle = mapping;
+    unmapFile(file);
+    delete geometry;
+    data = nullptr;
+    length = 0;
+    mapping = nullptr;
+    geometry = nullptr;
+    levelOffsets = nullptr;
+}
+
+Tablebase::Value Tablebase::probe(uint64_t firstMask, uint64_t secondMask) const {
+    if (!data || (firstMask & secondMask) || ((firstMask | secondMask) >> geometry->cells())) {
+        return Unknown;
+    }
+    int firstCount = popCount64(firstMask);
+    int secondCount = popCount64(secondMask);
+    if (firstCount != secondCount && firstCount != secondCount + 1) {
+        return Unknown;
+    }
+    int level = firstCount + secondCount;
+    return Value(readValue(data + levelOffsets[level], geometry->rank(firstMask, secondMask)));
+}
+
+int Tablebase::bestMove(uint64_t firstMask, uint64_t secondMask) const {
+    if (probe(firstMask, secondMask) == Unknown || geometry->hasLine(firstMask) || geometry->hasLine(secondMask)) {
+        return -1;
+    }
+    bool firstToMove = popCount64(firstMask) == popCount64(secondMask);
+    int bestCell = -1;
+    int bestValue = Unknown;
+    for (int cell = 0; cell < geometry->cells(); cell++) {
+        uint64_t bit = uint64_t(1) << cell;
+        if ((firstMask | secondMask) & bit) {
+            continue;
+        }
+        // The lower the opponent's value after our move, the better for us
+        int value = firstToMove ? probe(firstMask | bit, secondMask) : probe(firstMask, secondMask | bit);
+        if (value < bestValue) {
+            bestValue = value;
+            bestCell = cell;
+        }
+    }
+    return bestCell;
+}
+
+bool generateTablebase(const TablebaseOptions& options, std::string* error) {
+    if (options.rows < 1 || options.cols < 1 || options.rows * options.cols > TablebaseIndex::kMaxCells) {
+        return fail(error, "board must have between 1 and 32 cells");
+    }
+    if (options.k < 1 || options.path.empty()) {
+        return fail(error, "invalid win length or output path");
+    }
+    TablebaseIndex index(options.rows, options.cols, options.k);
+    int cells = index.cells();
+    int threads = options.threads > 0 ? options.threads : int(std::max(1u, std::thread::hardware_concurrency()));
+    std::string prefix = options.tempDir.empty() ? options.path : options.tempDir + "/tablebase";
+    auto levelPath = [&](int level) { return prefix + ".level" + std::to_string(level) + ".tmp"; };
+    // Deletes the level files from `level` up to the full board
+    auto removeLevels = [&](int level) {
+        for (; level <= cells; level++) {
+            std::remove(levelPath(level).c_str());
+        }
+    };
+
+    // Work backwards from the full board; only level + 1 stays mapped
+    MappedFile next;
+    for (int level = cells; level >= 0; level--) {
+        uint64_t size = index.levelSize(level);
+        std::vector<unsigned char> values(size_t((size + 3) / 4), 0);
+        const uint64_t block = 1 << 14; // a multiple of 4, so no byte is shared between threads
+        std::atomic<uint64_t> nextBlock(0);
+        auto worker = [&]() {
+            for (;;) {
+                uint64_t start = nextBlock.fetch_add(block);
+                if (start >= size) {
+                    return;
+                }
+                uint64_t end = std::min(size, start + block);
+                for (uint64_t i = start; i < end; i++) {
+                    uint64_t first;
+                    uint64_t second;
+                    index.unrank(level, i, first, second);
+                    int value = solvePosition(index, level, first, second, next.data);
+                    values[size_t(i >> 2)] |= (unsigned char)(value << ((i & 3) * 2));
+                }
+            }
+        };
+        std::vector<std::thread> pool;
+        for (int t = 1; t < threads; t++) {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (std::thread& thread : pool) {
+            thread.join();
+        }
+
+        std::ofstream out(levelPath(level), std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(values.data()), std::streamsize(values.size()));
+        out.close();
+        unmapFile(next);
+        if (!out || !mapFile(levelPath(level), next)) {
+            removeLevels(level);
+            return fail(error, "cannot write " + levelPath(level));
+        }
+    }
+    unmapFile(next);
+
+    // Stitch the levels together behind the header, smallest level first
+    TablebaseHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.rows = uint32_t(options.rows);
+    header.cols = uint32_t(options.cols);
+    header.k = uint32_t(options.k);
+    header.cells = uint32_t(cells);
+    uint64_t offset = sizeof(header);
+    for (int level = 0; level <= cells; level++) {
+        header.levelOffset[level] = offset;
+        offset += (index.levelSize(level) + 3) / 4;
+    }
+    header.levelOffset[cells + 1] = offset;
+
+    std::ofstream out(options.path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::vector<char> buffer(1 << 20);
+    for (int level = 0; level <= cells; level++) {
+        std::ifstream in(levelPath(level), std::ios::binary);
+        bool copied = in.is_open();
+        while (copied && in && out) {
+            in.read(buffer.data(), std::streamsize(buffer.size()));
+            out.write(buffer.data(), in.gcount());
+        }
+        // A clean copy stops at end of file, never on a read error
+        copied = copied && in.eof() && !in.bad();
+        in.close();
+        if (!copied || !out) {
+            out.close();
+            std::remove(options.path.c_str());
+            removeLevels(level);
+            return fail(error, !out ? "cannot write " + options.path : "cannot read " + levelPath(level));
+        }
+        std::remove(levelPath(level).c_str());
+    }
+    out.close();
+    if (!out) {
+        std::remove(options.path.c_str());
+        return fail(error, "cannot write " + options.path);
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Position indexing shared by the retrograde solver and the reader.
+// A board of up to 32 cells is stored level by level, where level n holds
+// every position with n stones: ceil(n / 2) for the first player and
+// floor(n / 2) for the second. Within a level a position is numbered by the
+// rank of its occupied cells, then by the rank of the first player's stones
+// among them (combinatorial number system).
+class TablebaseIndex {
+public:
+    static const int kMaxCells = 32;
+
+    TablebaseIndex(int rows, int cols, int k);
+
+    int rows() const { return rowCount; }
+    int cols() const { return colCount; }
+    int k() const { return winLength; }
+    int cells() const { return rowCount * colCount; }
+
+    uint64_t levelSize(int level) const;
+    uint64_t rank(uint64_t firstMask, uint64_t secondMask) const; // within its level
+    void unrank(int level, uint64_t index, uint64_t& firstMask, uint64_t& secondMask) const;
+    bool hasLine(uint64_t mask) const;
+
+private:
+    uint64_t choose(int n, int r) const { return r < 0 || r > n ? 0 : binomial[n][r]; }
+
+    int rowCount;
+    int colCount;
+    int winLength;
+    std::vector<uint64_t> lines;
+    uint64_t binomial[kMaxCells + 1][kMaxCells + 1];
+};
+
+// Read-only view of a tablebase file written by generateTablebase(). The file
+// is memory-mapped, so opening it costs nothing and pages load on demand.
+class Tablebase {
+public:
+    enum Value { Loss = 0, Draw = 1, Win = 2, Unknown = 3 }; // for the side to move
+
+    Tablebase();
+    ~Tablebase();
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+    const TablebaseIndex* index() const { return geometry; }
+
+    // Masks of the player who moved first and of the other player. Positions
+    // whose stone counts do not fit a first-player-starts game are Unknown.
+    Value probe(uint64_t firstMask, uint64_t secondMask) const;
+    int bestMove(uint64_t firstMask, uint64_t secondMask) const; // cell or -1
+
+private:
+    const unsigned char* data;
+    size_t length;
+    void* mapping; // platform handle kept for close()
+    TablebaseIndex* geometry;
+    const uint64_t* levelOffsets;
+};
+
+struct TablebaseOptions {
+    int rows = 3;
+    int cols = 3;
+    int k = 3;
+    std::string path;    // output file
+    std::string tempDir; // intermediate level files, defaults to the output's folder
+    int threads = 0;     // 0 = one per hardware thread
+};
+
+// Offline retrograde solver: works from the full board back to the empty one,
+// keeping only two levels in memory and spilling each level to disk.
+bool generateTablebase(const TablebaseOptions& options, std::string* error = nullptr);
+
+#endif // TABLEBASE_H
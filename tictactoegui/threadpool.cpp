@@ -0,0 +1,58 @@
+#include "threadpool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0) {
+        threads = int(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    for (int index = 1; index < threads; index++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, index);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(const std::function<void(int)>& task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current = &task;
+        pending = int(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+    task(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return pending == 0; });
+    current = nullptr;
+}
+
+void ThreadPool::workerLoop(int index) {
+    unsigned seen = 0;
+    for (;;) {
+        const std::function<void(int)>* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return quit || generation != seen; });
+            if (quit) {
+                return;
+            }
+            seen = generation;
+            task = current;
+        }
+        (*task)(index);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending--;
+        }
+        done.notify_one();
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that live as long as the pool, so a search
+// does not pay for thread creation on every move. run() hands the same
+// task to every worker (each gets its index) and waits for all of them.
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads = 0); // 0: one per hardware thread
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return int(workers.size()) + 1; }
+
+    // Calls task(index) once for every index in [0, size()); index 0 runs
+    // on the calling thread. Not reentrant.
+    void run(const std::function<void(int)>& task);
+
+private:
+    void workerLoop(int index);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(int)>* current = nullptr;
+    unsigned generation = 0; // bumped for every run(), so workers see new work
+    int pending = 0;         // workers still busy with the current task
+    bool quit = false;
+};
+
+#endif // THREADPOOL_H
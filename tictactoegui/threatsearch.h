@@ -0,0 +1,299 @@
+#ifndef THREATSEARCH_H
+#define THREATSEARCH_H
+
+#include "boardsearch.h"
+#include "linewindows.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct ThreatStats {
+    uint64_t nodes = 0;
+    int depth = 0;       // attacker moves in the win found, 0 if none
+    bool vct = false;    // found only once open threes were allowed
+    bool timedOut = false;
+};
+
+// Threat-space search: looks for a forced win made only of threats, the
+// way gomoku players read them. Works on any k, with the threats scaled
+// to it:
+//   four  - a move after which the attacker can complete K on some cell;
+//           the defender must take that cell (two such cells win)
+//   three - a move after which some cell would give two such cells (an
+//           open four); the defender must take one of the cells involved
+//           or answer with a four of their own
+// VCF (victory by continuous fours) uses fours only, so every defender
+// reply is forced and the search is a single line. VCT adds threes; every
+// defence is tried.
+//
+// Dependency-based pruning: after the first move, a threat must lie in a
+// window that contains one of the attacker's stones from this sequence.
+// Threats that do not build on earlier ones can be played later, so
+// searching them now only multiplies the same lines. Positions that failed
+// at a given depth are remembered, and the depth grows one attacker move
+// at a time so the shortest win is found first.
+template <class Board>
+class ThreatSearch {
+public:
+    explicit ThreatSearch(int vcfDepth = 12, int vctDepth = 4) : maxVCF(vcfDepth), maxVCT(vctDepth) {}
+
+    // First move of a forced win for player, VCF before VCT, or -1 if none
+    // was found within the limits (limits.maxDepth caps attacker moves)
+    int findWin(const Board& board, int player, const SearchLimits& limits = SearchLimits()) {
+        stats = ThreatStats();
+        line.clear();
+        if (board.checkWin() != 0) {
+            return -1;
+        }
+        prepare(board);
+        budget = limits;
+        start = std::chrono::steady_clock::now();
+        Board work = board;
+        gain.assign(size_t(work.cells()), 0);
+        int vcf_depth = std::min(maxVCF, limits.maxDepth);
+        int vct_depth = std::min(maxVCT, limits.maxDepth);
+        for (int pass = 0; pass < 2 && !stats.timedOut; pass++) {
+            bool threes = pass == 1;
+            failed.clear();
+            for (int depth = 1; depth <= (threes ? vct_depth : vcf_depth) && !stats.timedOut; depth++) {
+                if (attack(work, player, depth, threes, 0)) {
+                    stats.depth = depth;
+                    stats.vct = threes;
+                    return line.front();
+                }
+            }
+        }
+        return -1;
+    }
+
+    // Moves of the win found by the last findWin, attacker first; for VCT
+    // only the line against the first defence tried
+    const std::vector<int>& sequence() const { return line; }
+
+    const ThreatStats& lastSearch() const { return stats; }
+
+private:
+    static constexpr int kMaxCells = 16; // win cells collected per query
+
+    // Windows for the board's size, rebuilt only when the size changes
+    void prepare(const Board& board) {
+        geometry.build(board.rows(), board.cols(), board.k());
+        winLength = geometry.k;
+        colCount = geometry.cols;
+    }
+
+    int owner(const Board& board, int cell) const { return board.getValue(cell / colCount, cell % colCount); }
+
+    // Empty cells completing K for player in a window through cell
+    int winCellsThrough(const Board& board, int player, int cell, int* out) const {
+        int count = 0;
+        for (int slot : geometry.through[size_t(cell)]) {
+            int window = slot / winLength;
+            int empty = -1;
+            int own = 0;
+            for (int i = 0; i < winLength; i++) {
+                int c = geometry.cells[size_t(window * winLength + i)];
+                int value = owner(board, c);
+                if (value == player) {
+                    own++;
+                } else if (value == 0) {
+                    empty = c;
+                } else {
+                    own = -1;
+                    break;
+                }
+            }
+            if (own == winLength - 1 && std::find(out, out + count, empty) == out + count && count < kMaxCells) {
+                out[count++] = empty;
+            }
+        }
+        return count;
+    }
+
+    // Every empty cell completing K for player
+    int winCells(Board& board, int player, int* out) const {
+        int count = 0;
+        for (int cell = 0; cell < board.cells(); cell++) {
+            if (board.isEmpty(cell)) {
+                board.play(cell, player);
+                bool wins = board.checkWinAfter(cell) == player;
+                board.undo(cell);
+                if (wins && count < kMaxCells) {
+                    out[count++] = cell;
+                }
+            }
+        }
+        return count;
+    }
+
+    // Cells the defender must consider after the attacker's move at cell,
+    // if it made a three: each cell that would make an open four, and the
+    // win cells that open four would have
+    bool threeDefences(Board& board, int attacker, int cell, std::vector<int>& defences) const {
+        defences.clear();
+        int wins[kMaxCells];
+        for (int slot : geometry.through[size_t(cell)]) {
+            int window = slot / winLength;
+            int own = 0;
+            int empties = 0;
+            for (int i = 0; i < winLength; i++) {
+                int value = owner(board, geometry.cells[size_t(window * winLength + i)]);
+                own += value == attacker ? 1 : 0;
+                empties += value == 0 ? 1 : 0;
+            }
+            if (own != winLength - 2 || empties != 2) {
+                continue;
+            }
+            for (int i = 0; i < winLength; i++) {
+                int e = geometry.cells[size_t(window * winLength + i)];
+                if (!board.isEmpty(e)) {
+                    continue;
+                }
+                board.play(e, attacker);
+                int count = winCellsThrough(board, attacker, e, wins);
+                board.undo(e);
+                if (count >= 2) {
+                    defences.push_back(e);
+                    defences.insert(defences.end(), wins, wins + count);
+                }
+            }
+        }
+        std::sort(defences.begin(), defences.end());
+        defences.erase(std::unique(defences.begin(), defences.end()), defences.end());
+        return !defences.empty();
+    }
+
+    // Does cell share a window with a stone the attacker played earlier in
+    // this sequence?
+    bool dependsOnGain(int cell) const {
+        for (int slot : geometry.through[size_t(cell)]) {
+            int window = slot / winLength;
+            for (int i = 0; i < winLength; i++) {
+                if (gain[size_t(geometry.cells[size_t(window * winLength + i)])]) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool outOfBudget() {
+        if ((budget.nodes != 0 && stats.nodes >= budget.nodes) ||
+            (budget.timeMs != 0 && (stats.nodes & 63) == 0 &&
+             std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(budget.timeMs))) {
+            stats.timedOut = true;
+        }
+        return stats.timedOut;
+    }
+
+    // Attacker to move with depth threats left; on success line holds the
+    // win from here
+    bool attack(Board& board, int attacker, int depth, bool threes, int ply) {
+        stats.nodes++;
+        if (outOfBudget()) {
+            return false;
+        }
+        int wins[kMaxCells];
+        if (winCells(board, attacker, wins) > 0) {
+            line.assign(1, wins[0]);
+            return true;
+        }
+        if (depth == 0) {
+            return false;
+        }
+        uint64_t key = board.hash() ^ (threes ? 0x5851F42D4C957F2Dull : 0) ^ (attacker > 0 ? 0x14057B7EF767814Full : 0);
+        auto known = failed.find(key);
+        if (known != failed.end() && known->second >= depth) {
+            return false;
+        }
+
+        // A defender four must be blocked, and two cannot be
+        int threats[kMaxCells];
+        int threat_count = winCells(board, -attacker, threats);
+        if (threat_count >= 2) {
+            return false;
+        }
+        bool found = false;
+        std::vector<int> defences;
+        for (int cell = 0; cell < board.cells() && !found && !stats.timedOut; cell++) {
+            if (!board.isEmpty(cell) || (threat_count == 1 && cell != threats[0]) ||
+                (ply > 0 && threat_count == 0 && !dependsOnGain(cell))) {
+                continue;
+            }
+            board.play(cell, attacker);
+            gain[size_t(cell)] = 1;
+            int count = winCellsThrough(board, attacker, cell, wins);
+            if (count >= 2) {
+                line.assign(1, wins[0]); // Two ways to win: the defender can block one
+                line.insert(line.begin(), wins[1]);
+                found = true;
+            } else if (count == 1) {
+                // Four: the reply is forced
+                board.play(wins[0], -attacker);
+                found = board.checkWinAfter(wins[0]) == 0 && attack(board, attacker, depth - 1, threes, ply + 1);
+                board.undo(wins[0]);
+                if (found) {
+                    line.insert(line.begin(), wins[0]);
+                }
+            } else if (threes && threeDefences(board, attacker, cell, defences)) {
+                found = defend(board, attacker, depth - 1, ply + 1, defences);
+            }
+            gain[size_t(cell)] = 0;
+            board.undo(cell);
+            if (found) {
+                line.insert(line.begin(), cell);
+            }
+        }
+        if (!found && !stats.timedOut) {
+            failed[key] = depth;
+        }
+        return found;
+    }
+
+    // Defender to move after a three: every defence and every counter-four
+    // must lose
+    bool defend(Board& board, int attacker, int depth, int ply, std::vector<int> defences) {
+        int wins[kMaxCells];
+        for (int cell = 0; cell < board.cells(); cell++) {
+            if (board.isEmpty(cell) && std::find(defences.begin(), defences.end(), cell) == defences.end()) {
+                board.play(cell, -attacker);
+                if (winCellsThrough(board, -attacker, cell, wins) > 0) {
+                    defences.push_back(cell);
+                }
+                board.undo(cell);
+            }
+        }
+        std::vector<int> first_line;
+        for (size_t i = 0; i < defences.size(); i++) {
+            int reply = defences[i];
+            board.play(reply, -attacker);
+            bool lost = board.checkWinAfter(reply) == 0 && attack(board, attacker, depth, true, ply);
+            board.undo(reply);
+            if (!lost) {
+                return false;
+            }
+            if (i == 0) {
+                first_line = line;
+                first_line.insert(first_line.begin(), reply);
+            }
+        }
+        line = first_line;
+        return true;
+    }
+
+    int maxVCF;
+    int maxVCT;
+    LineWindows geometry;
+    int colCount = 0;
+    int winLength = 0;
+    std::vector<char> gain;                // attacker stones of the current sequence
+    std::unordered_map<uint64_t, int> failed; // position -> depth it failed at
+    std::vector<int> line;
+    SearchLimits budget;
+    std::chrono::steady_clock::time_point start;
+    ThreatStats stats;
+};
+
+#endif // THREATSEARCH_H
@@ -0,0 +1,61 @@
+#include "transpositiontable.h"
+
+namespace {
+
+// Packs an entry into one word: score in bits 0-31, bestMove 32-47,
+// depth 48-55 and bound 56-63; bound None (an empty slot) packs to 0
+uint64_t pack(int score, int bestMove, int depth, TranspositionTable::Bound bound) {
+    return uint64_t(uint32_t(score)) | (uint64_t(uint16_t(bestMove)) << 32) |
+           (uint64_t(uint8_t(depth)) << 48) | (uint64_t(bound) << 56);
+}
+
+void unpack(uint64_t key, uint64_t data, TranspositionTable::Entry& entry) {
+    entry.key = key;
+    entry.score = int32_t(uint32_t(data));
+    entry.bestMove = int16_t(uint16_t(data >> 32));
+    entry.depth = int8_t(uint8_t(data >> 48));
+    entry.bound = uint8_t(data >> 56);
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(size_t count) {
+    size_t capacity = 1;
+    while (capacity < count) {
+        capacity <<= 1;
+    }
+    slots.reset(new Slot[capacity]);
+    indexMask = capacity - 1;
+    clear();
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry& entry) const {
+    const Slot& slot = slots[key & indexMask];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key || (data >> 56) == None) {
+        return false; // Empty, another position, or torn by a concurrent store
+    }
+    unpack(key, data, entry);
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, int score, Bound bound, int depth, int bestMove) {
+    Slot& slot = slots[key & indexMask];
+    uint64_t old_data = slot.data.load(std::memory_order_relaxed);
+    uint64_t old_check = slot.check.load(std::memory_order_relaxed);
+    // Keep a deeper result for the same position, otherwise always replace
+    if ((old_check ^ old_data) == key && (old_data >> 56) != None && int8_t(uint8_t(old_data >> 48)) > depth) {
+        return;
+    }
+    uint64_t data = pack(score, bestMove, depth > 127 ? 127 : depth, bound);
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= indexMask; i++) {
+        slots[i].data.store(0, std::memory_order_relaxed);
+        slots[i].check.store(0, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Fixed-size, direct-mapped cache of search results keyed on a position hash.
+//
+// Safe to share between search threads without locks. Each slot holds two
+// 64-bit words: the packed entry, and the key XORed with it. Both words
+// are read and written with relaxed atomics, which are plain moves on
+// x86-64. A slot torn by two concurrent stores fails the XOR check and
+// reads as a miss, so it can never produce another position's result.
+class TranspositionTable {
+public:
+    enum Bound : uint8_t {
+        None,
+        Exact, // score is the true value of the position
+        Lower, // search failed high: true value >= score
+        Upper  // search failed low: true value <= score
+    };
+
+    struct Entry {
+        uint64_t key;
+        int32_t score;
+        int16_t bestMove; // cell index, -1 if none
+        int8_t depth;
+        uint8_t bound;
+    };
+
+    // The entry count is rounded up to a power of two
+    explicit TranspositionTable(size_t entries = 1 << 16);
+
+    bool probe(uint64_t key, Entry& entry) const;
+    void store(uint64_t key, int score, Bound bound, int depth, int bestMove);
+    void clear(); // Not safe while other threads search
+
+    size_t size() const { return indexMask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check; // key ^ data
+        std::atomic<uint64_t> data;  // score, bestMove, depth, bound
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t indexMask;
+};
+
+#endif // TRANSPOSITIONTABLE_H
@@ -10,18 +10,51 @@ CONFIG += c++17
 
 SOURCES += \
     aiplayer.cpp \
+    batcheval.cpp \
     gameboard.cpp \
+    gametree.cpp \
+    gridboard.cpp \
+    linescan.cpp \
     main.cpp \
     mainwindow.cpp \
+    nnueeval.cpp \
+    perfectplay.cpp \
+    transpositiontable.cpp \
     shell.c \
-    sqlite3.c
+    sqlite3.c \
+    tablebase.cpp \
+    threadpool.cpp
 
 HEADERS += \
     aiplayer.h \
+    batcheval.h \
+    bitops.h \
+    boardsearch.h \
     gameboard.h \
+    gametree.h \
+    gridboard.h \
+    leafeval.h \
+    linescan.h \
+    linewindows.h \
     mainwindow.h \
+    mctssearch.h \
+    mnkboard.h \
+    moveordering.h \
+    nnueeval.h \
+    parallelmcts.h \
+    parallelsearch.h \
+    patterneval.h \
+    perfectplay.h \
+    proofsearch.h \
     sqlite3.h \
-    sqlite3ext.h
+    sqlite3ext.h \
+    tablebase.h \
+    threatsearch.h \
+    threadpool.h \
+    transpositiontable.h \
+    workstealingdeque.h \
+    ybwcsearch.h \
+    zobrist.h
 
 FORMS += \
     mainwindow.ui
@@ -0,0 +1,103 @@
+#ifndef WORKSTEALINGDEQUE_H
+#define WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Chase-Lev work-stealing deque (with the C11 memory orders of Le et al.,
+// "Correct and Efficient Work-Stealing for Weak Memory Models"). The owning
+// thread pushes and pops at the bottom without contention; other threads
+// steal from the top, and only a steal racing the owner for the last
+// element costs a CAS. T must be trivially copyable (a task pointer).
+//
+// The buffer doubles when full. Old buffers are kept until the deque is
+// destroyed, since a thief may still be reading one.
+template <class T>
+class WorkStealingDeque {
+public:
+    explicit WorkStealingDeque(int64_t capacity = 64) : top(0), bottom(0) {
+        buffers.emplace_back(new Buffer(capacity));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only
+    void push(T item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Buffer* current = buffer.load(std::memory_order_relaxed);
+        if (b - t > current->capacity - 1) {
+            current = grow(current, t, b);
+        }
+        current->put(b, item);
+        bottom.store(b + 1, std::memory_order_release); // Publishes the item to thieves
+    }
+
+    // Owner only; false when empty
+    bool pop(T& item) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* current = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed); // Was empty
+            return false;
+        }
+        item = current->get(b);
+        if (t == b) {
+            // Last element: race the thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread; false when empty or when another thread won the race
+    bool steal(T& item) {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        Buffer* current = buffer.load(std::memory_order_acquire);
+        item = current->get(t);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return top.load(std::memory_order_relaxed) >= bottom.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Buffer {
+        explicit Buffer(int64_t size) : capacity(size), slots(new std::atomic<T>[size]) {}
+        T get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t i, T item) { slots[i & (capacity - 1)].store(item, std::memory_order_relaxed); }
+
+        int64_t capacity; // a power of two
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    Buffer* grow(Buffer* old, int64_t t, int64_t b) {
+        buffers.emplace_back(new Buffer(old->capacity * 2));
+        Buffer* bigger = buffers.back().get();
+        for (int64_t i = t; i < b; i++) {
+            bigger->put(i, old->get(i));
+        }
+        buffer.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    std::atomic<int64_t> top;
+    std::atomic<int64_t> bottom;
+    std::atomic<Buffer*> buffer;
+    std::vector<std::unique_ptr<Buffer>> buffers; // Owner only
+};
+
+#endif // WORKSTEALINGDEQUE_H
@@ -0,0 +1,482 @@
+#ifndef YBWCSEARCH_H
+#define YBWCSEARCH_H
+
+#include "boardsearch.h"
+#include "moveordering.h"
+#include "threadpool.h"
+#include "transpositiontable.h"
+#include "workstealingdeque.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Young Brothers Wait parallel alpha-beta. Every node searches its eldest
+// child (the table move) itself; only when that does not cut off do the
+// younger siblings become tasks on the thread's Chase-Lev deque. The owner
+// works through its own tasks while idle threads steal from the other end.
+// A sibling that fails high cancels its split point: queued siblings are
+// dropped and running ones unwind at their next node, as do their own
+// split points further down.
+//
+// Scores and table entries use the same form as BoardSearch (maximizing
+// player's view, same keys), so the two can share a table. The root keeps
+// the serial tie rule: later root moves get the window (best - 1, beta),
+// so ties are exact and go to the lowest cell.
+//
+// Moves are ordered as in BoardSearch (table move, killers, history, then
+// the line prior). Each worker keeps its own MoveOrdering, filled by the
+// cutoffs it finds itself, so the eldest brother is the best guess without
+// any sharing between threads.
+//
+// With pattern evaluation on, leaves cut off by the depth limit are scored
+// like BoardSearch with a PatternEvaluator. Each worker keeps one
+// evaluator per level of task nesting, because a worker waiting at a split
+// point runs other tasks on other positions in between.
+template <class Board>
+class YBWCSearch {
+public:
+    static constexpr int kWinScore = BoardSearch<Board>::kWinScore;
+    static constexpr int kInfinity = kWinScore + 1;
+
+    // Nodes with fewer than splitDepth plies below them stay serial
+    explicit YBWCSearch(int threads = 0, size_t tableEntries = 1 << 16, int splitDepth = 3)
+        : pool(threads), table(tableEntries), minSplitDepth(splitDepth) {
+        for (int i = 0; i < pool.size(); i++) {
+            workers.emplace_back(new Worker(i));
+        }
+    }
+
+    int threads() const { return pool.size(); }
+
+    // Probe and store in other instead of the own table (nullptr: own table)
+    void shareTable(TranspositionTable* other) { shared = other; }
+
+    void clear() { activeTable().clear(); }
+
+    // Off: the table move first, then plain board order (for comparisons)
+    void setMoveOrdering(bool enabled) {
+        for (auto& worker : workers) {
+            worker->order.setEnabled(enabled);
+        }
+    }
+
+    // Score unfinished leaves with PatternEvaluator instead of 0
+    void usePatternEvaluation(bool enabled) {
+        if (enabled != patternEvaluation) {
+            activeTable().clear(); // Stored scores came from the old leaf values
+            patternEvaluation = enabled;
+        }
+    }
+
+    // Iterative deepening over the parallel search; same limits and result
+    // as BoardSearch::bestMove
+    int bestMove(const Board& board, int player, const SearchLimits& searchLimits) {
+        if (player != maxPlayer) {
+            activeTable().clear(); // Stored scores are relative to the old side
+            maxPlayer = player;
+        }
+        stats = SearchStats();
+        if (board.checkWin() != 0) {
+            return -1;
+        }
+        limits = searchLimits;
+        start = std::chrono::steady_clock::now();
+        stop = false;
+        sharedNodes = 0;
+        for (auto& worker : workers) {
+            worker->reset();
+            worker->order.prepare(board);
+            worker->order.age();
+        }
+        int empty = 0;
+        for (int cell = 0; cell < board.cells(); cell++) {
+            empty += board.isEmpty(cell) ? 1 : 0;
+        }
+
+        int best_cell = -1;
+        std::atomic<bool> finished(false);
+        pool.run([&](int index) {
+            Worker& worker = *workers[index];
+            if (index != 0) {
+                while (!finished.load(std::memory_order_acquire)) {
+                    Task* task;
+                    if (stealTask(worker, task)) {
+                        runTask(worker, task);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+                return;
+            }
+            Board local = board;
+            worker.enterTask(local, patternEvaluation);
+            for (int depth = std::max(1, limits.startDepth); depth <= limits.maxDepth; depth++) {
+                int cell = -1;
+                int score = search(worker, local, -kInfinity, kInfinity, true, depth, 0, -1, nullptr, &cell);
+                if (stop) {
+                    break;
+                }
+                best_cell = cell;
+                stats.depth = depth;
+                stats.score = score;
+                if (depth >= empty || score == kWinScore || score == -kWinScore) {
+                    break;
+                }
+            }
+            finished.store(true, std::memory_order_release);
+        });
+
+        for (auto& worker : workers) {
+            stats.nodes += worker->nodes;
+            stats.splits += worker->splits;
+            stats.steals += worker->steals;
+            stats.aborts += worker->aborts;
+            stats.cutoffs += worker->cutoffs;
+            stats.firstMoveCutoffs += worker->firstMoveCutoffs;
+        }
+        for (int cell = 0; cell < board.cells() && best_cell == -1; cell++) {
+            best_cell = board.isEmpty(cell) ? cell : -1; // Not even depth 1 finished
+        }
+        return best_cell;
+    }
+
+    // Nodes and task counters summed over all threads
+    const SearchStats& lastSearch() const { return stats; }
+
+private:
+    // A node whose younger siblings were handed out as tasks. Lives on the
+    // owner's stack until every task has finished.
+    struct SplitPoint {
+        explicit SplitPoint(const Board& board) : position(board) {}
+
+        Board position;          // before the sibling moves
+        const SplitPoint* parent;
+        bool is_max;
+        int ply;                 // distance from the root
+        int depth;
+        int player;
+        int slack;               // 1 at the root, to keep ties exact
+        std::atomic<int> alpha;
+        std::atomic<int> beta;
+        std::atomic<int> pending; // tasks not finished yet
+        std::atomic<bool> cutoff; // a sibling failed high: drop the rest
+        std::mutex mutex;         // guards the two below
+        int bestScore;
+        int bestMove;
+    };
+
+    struct Task {
+        SplitPoint* split;
+        int cell;
+    };
+
+    struct Worker {
+        explicit Worker(int i) : rng(uint32_t(i) * 2654435761u + 1) {}
+
+        void reset() {
+            ply = 0;
+            nodes = splits = steals = aborts = 0;
+            cutoffs = firstMoveCutoffs = 0;
+            nesting = 0;
+            heuristic = nullptr;
+        }
+
+        // Evaluator for a task starting at board; the caller restores
+        // heuristic and nesting when the task is done
+        void enterTask(const Board& board, bool enabled) {
+            if (!enabled) {
+                return;
+            }
+            while (nesting >= int(evaluators.size())) {
+                evaluators.emplace_back();
+            }
+            heuristic = &evaluators[size_t(nesting++)];
+            heuristic->reset(board);
+        }
+
+        WorkStealingDeque<Task*> deque;
+        std::deque<std::vector<uint64_t>> moveLists; // by stack depth; deque keeps references valid
+        std::deque<PatternEvaluator<Board>> evaluators; // by task nesting, likewise
+        PatternEvaluator<Board>* heuristic = nullptr;   // the current task's, if enabled
+        MoveOrdering order; // killers and history from this worker's own cutoffs
+        int nesting = 0;
+        int ply = 0; // stack depth, counting nested tasks
+        uint64_t nodes = 0;
+        uint64_t splits = 0;
+        uint64_t steals = 0;
+        uint64_t aborts = 0;
+        uint64_t cutoffs = 0;
+        uint64_t firstMoveCutoffs = 0;
+        std::mt19937 rng;
+    };
+
+    TranspositionTable& activeTable() { return shared != nullptr ? *shared : table; }
+
+    int evaluate(const Worker& worker, int result) const {
+        if (result == maxPlayer) {
+            return kWinScore;
+        } else if (result == -maxPlayer) {
+            return -kWinScore;
+        } else if (result == 0 && worker.heuristic != nullptr) {
+            return worker.heuristic->score(maxPlayer);
+        }
+        return 0;
+    }
+
+    // True when the search under split (and all its ancestors) is wasted
+    bool cancelled(const SplitPoint* split) const {
+        for (const SplitPoint* p = split; p != nullptr; p = p->parent) {
+            if (p->cutoff.load(std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return stop.load(std::memory_order_relaxed);
+    }
+
+    void pollBudget() {
+        uint64_t nodes = sharedNodes.fetch_add(256, std::memory_order_relaxed) + 256;
+        if (limits.nodes != 0 && nodes >= limits.nodes) {
+            stop = true;
+        }
+        if (limits.timeMs != 0 && std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(limits.timeMs)) {
+            stop = true;
+        }
+    }
+
+    bool stealTask(Worker& worker, Task*& task) {
+        int count = int(workers.size());
+        int first = int(worker.rng() % uint32_t(count));
+        for (int i = 0; i < count; i++) {
+            Worker& victim = *workers[(first + i) % count];
+            if (&victim != &worker && victim.deque.steal(task)) {
+                worker.steals++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Minimax-form alpha-beta; root_cell is set only at the root, which
+    // keeps its tie rule and ignores table cutoffs. ply is the distance from
+    // the root, for the killer slots.
+    int search(Worker& worker, Board& board, int alpha, int beta, bool is_max, int depth, int ply, int last_cell,
+               const SplitPoint* context, int* root_cell) {
+        if ((++worker.nodes & 255) == 0) {
+            pollBudget();
+        }
+        if (cancelled(context)) {
+            return 0;
+        }
+        int result = last_cell >= 0 ? board.checkWinAfter(last_cell) : board.checkWin();
+        if (result != 0 || depth == 0) {
+            return evaluate(worker, result);
+        }
+
+        int transform = 0;
+        uint64_t hash = BoardSearch<Board>::key(board, is_max, transform);
+        int tt_move = -1;
+        TranspositionTable::Entry entry;
+        if (activeTable().probe(hash, entry)) {
+            tt_move = BoardSearch<Board>::fromKeyCell(entry.bestMove, transform);
+            if (root_cell == nullptr && entry.depth >= depth) {
+                if (entry.bound == TranspositionTable::Exact) {
+                    return entry.score;
+                } else if (entry.bound == TranspositionTable::Lower) {
+                    alpha = std::max(alpha, entry.score);
+                } else if (entry.bound == TranspositionTable::Upper) {
+                    beta = std::min(beta, entry.score);
+                }
+                if (alpha >= beta) {
+                    return entry.score;
+                }
+            }
+        }
+
+        int cells = board.cells();
+        while (worker.ply >= int(worker.moveLists.size())) {
+            worker.moveLists.emplace_back(cells);
+        }
+        std::vector<uint64_t>& moves = worker.moveLists[size_t(worker.ply)];
+        int player = is_max ? maxPlayer : -maxPlayer;
+        int side = player > 0 ? 0 : 1;
+        int count = worker.order.generate(board, tt_move, side, ply, moves);
+
+        int alpha_orig = alpha;
+        int beta_orig = beta;
+        int slack = root_cell != nullptr ? 1 : 0;
+        int best_score = is_max ? -kInfinity : kInfinity;
+        int best_move = -1;
+        for (int i = 0; i < count; i++) {
+            if (i == 1 && count > 2 && workers.size() > 1 && std::min(depth, count) >= minSplitDepth) {
+                // The eldest brother is done without a cutoff: the rest may go in parallel
+                // Younger brothers go out best first
+                std::sort(moves.begin() + 1, moves.begin() + count, std::greater<uint64_t>());
+                SplitPoint split(board);
+                split.parent = context;
+                split.is_max = is_max;
+                split.ply = ply;
+                split.depth = depth;
+                split.player = player;
+                split.slack = slack;
+                split.alpha = alpha;
+                split.beta = beta;
+                split.cutoff = false;
+                split.bestScore = best_score;
+                split.bestMove = best_move;
+                searchSiblings(worker, split, moves, 1, count);
+                alpha = split.alpha;
+                beta = split.beta;
+                best_score = split.bestScore;
+                best_move = split.bestMove;
+                break;
+            }
+            int cell = MoveOrdering::pick(moves, i, count);
+            board.play(cell, player);
+            if (worker.heuristic != nullptr) {
+                worker.heuristic->place(cell, player);
+            }
+            worker.ply++;
+            int low = i > 0 && is_max ? alpha - slack : alpha;
+            int score = search(worker, board, low, beta, !is_max, depth - 1, ply + 1, cell, context, nullptr);
+            worker.ply--;
+            board.undo(cell);
+            if (worker.heuristic != nullptr) {
+                worker.heuristic->remove(cell, player);
+            }
+            if (cancelled(context)) {
+                return 0;
+            }
+            if (is_max ? (score > best_score || (score == best_score && cell < best_move))
+                       : (score < best_score || (score == best_score && cell < best_move))) {
+                best_score = score;
+                best_move = cell;
+            }
+            if (is_max) {
+                alpha = std::max(alpha, score);
+            } else {
+                beta = std::min(beta, score);
+            }
+            if (alpha >= beta) {
+                worker.order.recordCutoff(cell, side, ply, depth);
+                worker.cutoffs++;
+                worker.firstMoveCutoffs += i == 0 ? 1 : 0;
+                break;
+            }
+        }
+        if (cancelled(context)) {
+            return 0; // Incomplete results must not reach the table
+        }
+
+        TranspositionTable::Bound bound = TranspositionTable::Exact;
+        if (best_score <= alpha_orig) {
+            bound = TranspositionTable::Upper;
+        } else if (best_score >= beta_orig) {
+            bound = TranspositionTable::Lower;
+        }
+        activeTable().store(hash, best_score, bound, depth, BoardSearch<Board>::toKeyCell(best_move, transform));
+        if (root_cell != nullptr) {
+            *root_cell = best_move;
+        }
+        return best_score;
+    }
+
+    // Pushes moves[first, count) as tasks and helps until all are finished
+    void searchSiblings(Worker& worker, SplitPoint& split, const std::vector<uint64_t>& moves, int first, int count) {
+        std::vector<Task> tasks(size_t(count - first));
+        split.pending = count - first;
+        for (int i = count - 1; i >= first; i--) {
+            // Pushed last to first, so the owner pops them in move order
+            // and thieves take the least promising ones
+            tasks[size_t(i - first)] = Task{ &split, int(moves[size_t(i)] & 0xFFFFFFFFu) };
+            worker.deque.push(&tasks[size_t(i - first)]);
+        }
+        worker.splits++;
+        while (split.pending.load(std::memory_order_acquire) > 0) {
+            Task* task;
+            if (worker.deque.pop(task) || stealTask(worker, task)) {
+                runTask(worker, task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void runTask(Worker& worker, Task* task) {
+        SplitPoint& split = *task->split;
+        int low = split.alpha.load() - (split.is_max ? split.slack : 0);
+        int high = split.beta.load();
+        if (cancelled(&split) || low >= high) {
+            worker.aborts++;
+        } else {
+            Board board = split.position;
+            board.play(task->cell, split.player);
+            PatternEvaluator<Board>* outer = worker.heuristic;
+            int nesting = worker.nesting;
+            worker.enterTask(board, patternEvaluation);
+            worker.ply++;
+            int score = search(worker, board, low, high, !split.is_max, split.depth - 1, split.ply + 1, task->cell,
+                               &split, nullptr);
+            worker.ply--;
+            worker.heuristic = outer;
+            worker.nesting = nesting;
+            if (cancelled(&split)) {
+                worker.aborts++;
+            } else {
+                {
+                    std::lock_guard<std::mutex> lock(split.mutex);
+                    if (split.is_max ? (score > split.bestScore || (score == split.bestScore && task->cell < split.bestMove))
+                                     : (score < split.bestScore || (score == split.bestScore && task->cell < split.bestMove))) {
+                        split.bestScore = score;
+                        split.bestMove = task->cell;
+                    }
+                }
+                if (split.is_max) {
+                    int alpha = split.alpha.load();
+                    while (score > alpha && !split.alpha.compare_exchange_weak(alpha, score)) {
+                    }
+                    if (score >= split.beta.load()) {
+                        split.cutoff = true;
+                        recordSplitCutoff(worker, split, task->cell);
+                    }
+                } else {
+                    int beta = split.beta.load();
+                    while (score < beta && !split.beta.compare_exchange_weak(beta, score)) {
+                    }
+                    if (score <= split.alpha.load()) {
+                        split.cutoff = true;
+                        recordSplitCutoff(worker, split, task->cell);
+                    }
+                }
+            }
+        }
+        split.pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    // A younger brother refuted the split node; the worker that found it learns the move
+    void recordSplitCutoff(Worker& worker, const SplitPoint& split, int cell) {
+        worker.order.recordCutoff(cell, split.player > 0 ? 0 : 1, split.ply, split.depth);
+        worker.cutoffs++;
+    }
+
+    ThreadPool pool;
+    TranspositionTable table;
+    TranspositionTable* shared = nullptr;
+    int minSplitDepth;
+    int maxPlayer = -1;
+    bool patternEvaluation = false;
+    SearchLimits limits;
+    SearchStats stats;
+    std::chrono::steady_clock::time_point start;
+    std::atomic<bool> stop{ false };
+    std::atomic<uint64_t> sharedNodes{ 0 };
+    std::vector<std::unique_ptr<Worker>> workers;
+};
+
+#endif // YBWCSEARCH_H
@@ -0,0 +1,37 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <array>
+#include <cstdint>
+
+// Deterministic Zobrist keys generated with SplitMix64, usable at compile time.
+// Key (cell, side) lives at index cell * 2 + (side > 0 ? 0 : 1).
+constexpr uint64_t zobristMix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+constexpr uint64_t zobristKey(int cell, int player) {
+    return zobristMix(0x5A0B7157ull + uint64_t(cell) * 2 + (player > 0 ? 0 : 1));
+}
+
+// The same keys precomputed for a board of Cells cells, for use on hot paths
+template <int Cells>
+struct ZobristKeys {
+    static constexpr std::array<uint64_t, Cells * 2> make() {
+        std::array<uint64_t, Cells * 2> keys{};
+        for (int cell = 0; cell < Cells; ++cell) {
+            keys[cell * 2] = zobristKey(cell, 1);
+            keys[cell * 2 + 1] = zobristKey(cell, -1);
+        }
+        return keys;
+    }
+
+    static constexpr std::array<uint64_t, Cells * 2> keys = make();
+
+    static uint64_t key(int cell, int player) { return keys[cell * 2 + (player > 0 ? 0 : 1)]; }
+};
+
+#endif // ZOBRIST_H